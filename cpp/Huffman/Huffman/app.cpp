@@ -1,4 +1,4 @@
-#ifndef TEST_BUILD
+#if !defined(TEST_BUILD) && !defined(BENCHMARK_BUILD)
 
 #include <fstream>
 #include "encoding/encodings.h"
@@ -24,7 +24,7 @@ int main()
     const std::string file_b = R"(g:\temp\aaaaa\b.txt)";
     const std::string file_c = R"(g:\temp\aaaaa\c.txt)";
 
-    auto pipeline = predictive_encoding<256>(encoding::predictive::trie_oracle(5)) | eof_encoding<256>() | adaptive_huffman<257>() | bit_grouper<8>();
+    auto pipeline = predictive_encoding<256>([]() { return encoding::predictive::trie_oracle(5); }) | eof_encoding<256>() | adaptive_huffman<257>() | bit_grouper<8>();
     
     {
         auto input = io::create_file_data_source(file_a);
@@ -0,0 +1,158 @@
+#include "benchmarks/allocation-counter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+    // Trivially constructible, so safe to use from operator new before anything else is initialized
+    thread_local u64 allocation_count = 0;
+    thread_local u64 allocated_bytes = 0;
+}
+
+encoding::instrumentation::AllocationCounts benchmarks::allocation_counts()
+{
+    return encoding::instrumentation::AllocationCounts{ allocation_count, allocated_bytes };
+}
+
+void benchmarks::install_allocation_probe()
+{
+    encoding::instrumentation::set_allocation_probe(&allocation_counts);
+}
+
+#ifdef BENCHMARK_BUILD
+
+namespace
+{
+    void* allocate(size_t size)
+    {
+        ++allocation_count;
+        allocated_bytes += size;
+
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* allocate_aligned(size_t size, std::align_val_t alignment)
+    {
+        ++allocation_count;
+        allocated_bytes += size;
+
+        auto align = static_cast<size_t>(alignment);
+
+        // Zero sized requests must still return a unique pointer, which aligned_alloc(align, 0) need not do
+        size = std::max<size_t>(size, 1);
+
+#ifdef _WIN32
+        return _aligned_malloc(size, align);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    }
+
+    void deallocate_aligned(void* pointer)
+    {
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void* operator new(size_t size)
+{
+    auto result = allocate(size);
+
+    if (result == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return result;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    auto result = allocate_aligned(size, alignment);
+
+    if (result == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return result;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    deallocate_aligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    deallocate_aligned(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+    deallocate_aligned(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+    deallocate_aligned(pointer);
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include "encoding/instrumentation.h"
+
+
+namespace benchmarks
+{
+    // In benchmark builds, the global operator new is replaced by one that counts the allocations of every
+    // thread. Other builds use the standard allocator and the counts remain zero
+#ifdef BENCHMARK_BUILD
+    constexpr bool ALLOCATIONS_COUNTED = true;
+#else
+    constexpr bool ALLOCATIONS_COUNTED = false;
+#endif
+
+    // Allocations made by the calling thread since it started
+    encoding::instrumentation::AllocationCounts allocation_counts();
+
+    // Makes instrumented encodings report allocations
+    void install_allocation_probe();
+}
+
+#endif
@@ -0,0 +1,292 @@
+#include "benchmarks/benchmark.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+
+namespace
+{
+    void append_counters(std::ostringstream& out, const benchmarks::CounterValues& counters)
+    {
+        out << '{';
+
+        for (size_t i = 0; i != benchmarks::COUNTER_COUNT; ++i)
+        {
+            if (i != 0)
+            {
+                out << ',';
+            }
+
+            out << '"' << benchmarks::counter_name(benchmarks::Counter(i)) << "_per_byte\":";
+
+            if (counters.available[i])
+            {
+                out << counters.values[i];
+            }
+            else
+            {
+                out << "null";
+            }
+        }
+
+        out << '}';
+    }
+
+    void print_counters(const char* operation, const benchmarks::CounterValues& counters, std::ostream& out)
+    {
+        out << std::left << std::setw(14) << "" << "  " << operation << " per byte:";
+
+        for (size_t i = 0; i != benchmarks::COUNTER_COUNT; ++i)
+        {
+            out << ' ' << benchmarks::counter_name(benchmarks::Counter(i)) << '=';
+
+            if (counters.available[i])
+            {
+                out << counters.values[i];
+            }
+            else
+            {
+                out << "n/a";
+            }
+        }
+
+        out << '\n';
+    }
+
+    void append_allocations(std::ostringstream& out, const benchmarks::AllocationResult& allocations)
+    {
+        out << "{\"encode_allocations_per_mb\":" << allocations.encode_allocations_per_mb;
+        out << ",\"encode_bytes_per_mb\":" << allocations.encode_bytes_per_mb;
+        out << ",\"decode_allocations_per_mb\":" << allocations.decode_allocations_per_mb;
+        out << ",\"decode_bytes_per_mb\":" << allocations.decode_bytes_per_mb;
+        out << '}';
+    }
+
+    void append_json_string(std::ostringstream& out, const std::string& string)
+    {
+        out << '"';
+
+        for (auto c : string)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\';
+            }
+
+            out << c;
+        }
+
+        out << '"';
+    }
+}
+
+double benchmarks::mb_per_second(u64 bytes, double seconds)
+{
+    return seconds > 0 ? double(bytes) / (1024.0 * 1024.0) / seconds : 0;
+}
+
+double benchmarks::per_mb(u64 count, u64 bytes)
+{
+    return bytes > 0 ? double(count) * (1024.0 * 1024.0) / double(bytes) : 0;
+}
+
+std::vector<benchmarks::StageResult> benchmarks::stage_results(const encoding::instrumentation::Recorder& recorder, u64 input_size)
+{
+    using encoding::instrumentation::Operation;
+
+    std::vector<StageResult> results;
+
+    for (auto& report : recorder.report())
+    {
+        auto it = std::find_if(results.begin(), results.end(), [&](const StageResult& result) { return result.stage == report.stage; });
+
+        if (it == results.end())
+        {
+            results.push_back(StageResult{ report.stage, 0, 0, AllocationResult{ 0, 0, 0, 0 } });
+            it = results.end() - 1;
+        }
+
+        auto total_size = input_size * report.statistics.calls;
+        auto speed = mb_per_second(total_size, report.statistics.wall_seconds);
+        auto allocations = per_mb(report.statistics.allocations, total_size);
+        auto bytes = per_mb(report.statistics.allocated_bytes, total_size);
+
+        if (report.operation == Operation::ENCODE)
+        {
+            it->encode_mb_per_second = speed;
+            it->allocations.encode_allocations_per_mb = allocations;
+            it->allocations.encode_bytes_per_mb = bytes;
+        }
+        else
+        {
+            it->decode_mb_per_second = speed;
+            it->allocations.decode_allocations_per_mb = allocations;
+            it->allocations.decode_bytes_per_mb = bytes;
+        }
+    }
+
+    return results;
+}
+
+benchmarks::CounterValues benchmarks::no_counters()
+{
+    CounterValues result;
+
+    result.values.fill(0);
+    result.available.fill(false);
+
+    return result;
+}
+
+benchmarks::CounterValues benchmarks::add(const CounterValues& x, const CounterValues& y)
+{
+    CounterValues result;
+
+    for (size_t i = 0; i != COUNTER_COUNT; ++i)
+    {
+        result.values[i] = x.values[i] + y.values[i];
+        result.available[i] = x.available[i] && y.available[i];
+    }
+
+    return result;
+}
+
+benchmarks::CounterValues benchmarks::per_byte(const CounterValues& values, u64 bytes)
+{
+    auto result = values;
+
+    for (auto& value : result.values)
+    {
+        value = bytes > 0 ? value / double(bytes) : 0;
+    }
+
+    return result;
+}
+
+void benchmarks::print(const std::vector<Result>& results, std::ostream& out)
+{
+    out << std::left << std::setw(14) << "corpus" << std::setw(44) << "encoding"
+        << std::right << std::setw(10) << "ratio" << std::setw(12) << "enc MB/s" << std::setw(12) << "dec MB/s" << '\n';
+
+    for (auto& result : results)
+    {
+        out << std::left << std::setw(14) << result.corpus << std::setw(44) << result.encoding
+            << std::right << std::fixed << std::setprecision(3) << std::setw(10) << result.ratio
+            << std::setw(12) << result.encode_mb_per_second << std::setw(12) << result.decode_mb_per_second
+            << (result.verified ? "" : "  DECODING FAILED") << '\n';
+
+        if (result.counters_measured)
+        {
+            print_counters("encode", result.encode_counters, out);
+            print_counters("decode", result.decode_counters, out);
+        }
+
+        for (auto& stage : result.stages)
+        {
+            out << std::left << std::setw(14) << "" << std::setw(44) << ("  " + stage.stage)
+                << std::right << std::setw(10) << "" << std::setw(12) << stage.encode_mb_per_second << std::setw(12) << stage.decode_mb_per_second << '\n';
+        }
+    }
+}
+
+void benchmarks::print_allocation_budget(const std::vector<Result>& results, std::ostream& out)
+{
+    struct Line
+    {
+        std::string name;
+        AllocationResult allocations;
+    };
+
+    std::vector<Line> lines;
+
+    for (auto& result : results)
+    {
+        lines.push_back(Line{ result.corpus + " / " + result.encoding, result.allocations });
+
+        for (auto& stage : result.stages)
+        {
+            lines.push_back(Line{ result.corpus + " / " + result.encoding + " / " + stage.stage, stage.allocations });
+        }
+    }
+
+    std::stable_sort(lines.begin(), lines.end(), [](const Line& x, const Line& y) {
+        return x.allocations.encode_allocations_per_mb + x.allocations.decode_allocations_per_mb > y.allocations.encode_allocations_per_mb + y.allocations.decode_allocations_per_mb;
+    });
+
+    out << std::left << std::setw(72) << "allocations per MB of input"
+        << std::right << std::setw(14) << "enc allocs" << std::setw(14) << "enc KB" << std::setw(14) << "dec allocs" << std::setw(14) << "dec KB" << '\n';
+
+    for (auto& line : lines)
+    {
+        out << std::left << std::setw(72) << line.name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << line.allocations.encode_allocations_per_mb << std::setw(14) << line.allocations.encode_bytes_per_mb / 1024
+            << std::setw(14) << line.allocations.decode_allocations_per_mb << std::setw(14) << line.allocations.decode_bytes_per_mb / 1024 << '\n';
+    }
+}
+
+std::string benchmarks::to_json(const std::vector<Result>& results)
+{
+    std::ostringstream out;
+    out.precision(9);
+
+    out << "{\"results\":[";
+
+    for (size_t i = 0; i != results.size(); ++i)
+    {
+        auto& result = results[i];
+
+        if (i != 0)
+        {
+            out << ',';
+        }
+
+        out << "{\"corpus\":";
+        append_json_string(out, result.corpus);
+        out << ",\"encoding\":";
+        append_json_string(out, result.encoding);
+        out << ",\"input_size\":" << result.input_size;
+        out << ",\"encoded_bits\":" << result.encoded_bits;
+        out << ",\"ratio\":" << result.ratio;
+        out << ",\"encode_mb_per_second\":" << result.encode_mb_per_second;
+        out << ",\"decode_mb_per_second\":" << result.decode_mb_per_second;
+        out << ",\"verified\":" << (result.verified ? "true" : "false");
+        out << ",\"allocations\":";
+        append_allocations(out, result.allocations);
+
+        if (result.counters_measured)
+        {
+            out << ",\"encode_counters\":";
+            append_counters(out, result.encode_counters);
+            out << ",\"decode_counters\":";
+            append_counters(out, result.decode_counters);
+        }
+
+        out << ",\"stages\":[";
+
+        for (size_t j = 0; j != result.stages.size(); ++j)
+        {
+            auto& stage = result.stages[j];
+
+            if (j != 0)
+            {
+                out << ',';
+            }
+
+            out << "{\"stage\":";
+            append_json_string(out, stage.stage);
+            out << ",\"encode_mb_per_second\":" << stage.encode_mb_per_second;
+            out << ",\"decode_mb_per_second\":" << stage.decode_mb_per_second;
+            out << ",\"allocations\":";
+            append_allocations(out, stage.allocations);
+            out << '}';
+        }
+
+        out << "]}";
+    }
+
+    out << "]}";
+
+    return out.str();
+}
@@ -0,0 +1,192 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "benchmarks/allocation-counter.h"
+#include "benchmarks/corpora.h"
+#include "benchmarks/perf-counters.h"
+#include "encoding/encoding.h"
+#include "encoding/instrumentation.h"
+#include "io/span-streams.h"
+#include "util.h"
+#include <algorithm>
+#include <chrono>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace benchmarks
+{
+    // Allocations per input megabyte, averaged over all repetitions
+    struct AllocationResult
+    {
+        double encode_allocations_per_mb;
+        double encode_bytes_per_mb;
+        double decode_allocations_per_mb;
+        double decode_bytes_per_mb;
+    };
+
+    // Time and allocations per input megabyte spent in one stage of a pipeline, averaged over all repetitions
+    struct StageResult
+    {
+        std::string stage;
+        double encode_mb_per_second;
+        double decode_mb_per_second;
+        AllocationResult allocations;
+    };
+
+    struct Result
+    {
+        std::string corpus;
+        std::string encoding;
+        u64 input_size;
+        u64 encoded_bits;
+
+        // Encoded bits per input bit
+        double ratio;
+
+        // Best of all repetitions
+        double encode_mb_per_second;
+        double decode_mb_per_second;
+
+        bool verified;
+        AllocationResult allocations;
+        std::vector<StageResult> stages;
+
+        // Hardware counters per input byte, if requested
+        bool counters_measured;
+        CounterValues encode_counters;
+        CounterValues decode_counters;
+    };
+
+    double mb_per_second(u64 bytes, double seconds);
+
+    double per_mb(u64 count, u64 bytes);
+
+    // Converts what recorder collected during a measurement into per stage results
+    std::vector<StageResult> stage_results(const encoding::instrumentation::Recorder& recorder, u64 input_size);
+
+    CounterValues no_counters();
+
+    // Sums values; a counter is only available if it was available in both
+    CounterValues add(const CounterValues& x, const CounterValues& y);
+
+    CounterValues per_byte(const CounterValues& values, u64 bytes);
+
+    // Encodes and decodes corpus repetitions times. If the stages of encoding were instrumented
+    // with recorder, their share of the time is reported as well. Given counters, hardware events
+    // are counted over all repetitions
+    template<u64 OUT>
+    Result measure(const std::string& name, encoding::Encoding<256, OUT> encoding, const NamedCorpus& corpus, unsigned repetitions, std::shared_ptr<encoding::instrumentation::Recorder> recorder = nullptr, PerfCounters* counters = nullptr)
+    {
+        typedef typename SelectIntegerTypeByDomainSize<OUT>::type encoded_type;
+        typedef std::chrono::steady_clock clock;
+
+        std::vector<encoded_type> encoded;
+        std::vector<uint8_t> decoded;
+        double best_encode = std::numeric_limits<double>::infinity();
+        double best_decode = std::numeric_limits<double>::infinity();
+        CounterValues encode_counters = no_counters();
+        CounterValues decode_counters = no_counters();
+        u64 encode_allocations = 0, encode_allocated_bytes = 0;
+        u64 decode_allocations = 0, decode_allocated_bytes = 0;
+
+        if (recorder != nullptr)
+        {
+            recorder->clear();
+        }
+
+        for (unsigned i = 0; i != repetitions; ++i)
+        {
+            encoded.clear();
+            decoded.clear();
+
+            io::SpanInputStream<uint8_t> input(corpus.data);
+            io::VectorOutputStream<encoded_type> encoded_output(encoded);
+
+            if (counters != nullptr)
+            {
+                counters->start();
+            }
+
+            auto allocations_before = allocation_counts();
+            auto start = clock::now();
+            encoding->encode(input, encoded_output);
+            auto middle = clock::now();
+            auto allocations_after = allocation_counts();
+
+            encode_allocations += allocations_after.count - allocations_before.count;
+            encode_allocated_bytes += allocations_after.bytes - allocations_before.bytes;
+
+            if (counters != nullptr)
+            {
+                encode_counters = i == 0 ? counters->stop() : add(encode_counters, counters->stop());
+            }
+
+            io::SpanInputStream<encoded_type> encoded_input(encoded);
+            io::VectorOutputStream<uint8_t> output(decoded);
+
+            if (counters != nullptr)
+            {
+                counters->start();
+            }
+
+            allocations_before = allocation_counts();
+            auto resumed = clock::now();
+            encoding->decode(encoded_input, output);
+            auto end = clock::now();
+            allocations_after = allocation_counts();
+
+            decode_allocations += allocations_after.count - allocations_before.count;
+            decode_allocated_bytes += allocations_after.bytes - allocations_before.bytes;
+
+            if (counters != nullptr)
+            {
+                decode_counters = i == 0 ? counters->stop() : add(decode_counters, counters->stop());
+            }
+
+            best_encode = std::min(best_encode, std::chrono::duration<double>(middle - start).count());
+            best_decode = std::min(best_decode, std::chrono::duration<double>(end - resumed).count());
+        }
+
+        Result result;
+        result.corpus = corpus.name;
+        result.encoding = name;
+        result.input_size = corpus.data.size();
+        result.encoded_bits = u64(encoded.size()) * bits_needed(OUT);
+        result.ratio = corpus.data.empty() ? 0 : double(result.encoded_bits) / double(8 * corpus.data.size());
+        result.encode_mb_per_second = mb_per_second(corpus.data.size(), best_encode);
+        result.decode_mb_per_second = mb_per_second(corpus.data.size(), best_decode);
+        result.verified = decoded == corpus.data;
+
+        auto total_size = u64(corpus.data.size()) * repetitions;
+        result.allocations.encode_allocations_per_mb = per_mb(encode_allocations, total_size);
+        result.allocations.encode_bytes_per_mb = per_mb(encode_allocated_bytes, total_size);
+        result.allocations.decode_allocations_per_mb = per_mb(decode_allocations, total_size);
+        result.allocations.decode_bytes_per_mb = per_mb(decode_allocated_bytes, total_size);
+
+        if (recorder != nullptr)
+        {
+            result.stages = stage_results(*recorder, corpus.data.size());
+        }
+
+        result.counters_measured = counters != nullptr;
+        result.encode_counters = per_byte(encode_counters, total_size);
+        result.decode_counters = per_byte(decode_counters, total_size);
+
+        return result;
+    }
+
+    // Aligned table for humans
+    void print(const std::vector<Result>& results, std::ostream& out);
+
+    // Allocations per input megabyte of every encoding and stage, busiest first
+    void print_allocation_budget(const std::vector<Result>& results, std::ostream& out);
+
+    // Machine-readable results, for comparing builds
+    std::string to_json(const std::vector<Result>& results);
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include "benchmarks/corpora.h"
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+
+namespace
+{
+    // splitmix64: unlike the standard distributions, its output is specified exactly
+    class Random
+    {
+    private:
+        u64 m_state;
+
+    public:
+        Random(u64 seed) : m_state(seed)
+        {
+            // NOP
+        }
+
+        u64 next()
+        {
+            u64 z = (m_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, bound)
+        u64 below(u64 bound)
+        {
+            assert(bound > 0);
+
+            return next() % bound;
+        }
+
+        // Uniform in [0, 1)
+        double unit()
+        {
+            return double(next() >> 11) * (1.0 / double(u64(1) << 53));
+        }
+    };
+
+    const char* const ENGLISH =
+        "It was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness, "
+        "it was the epoch of belief, it was the epoch of incredulity, it was the season of Light, it was the season of Darkness, "
+        "it was the spring of hope, it was the winter of despair, we had everything before us, we had nothing before us, "
+        "we were all going direct to Heaven, we were all going direct the other way - in short, the period was so far like "
+        "the present period, that some of its noisiest authorities insisted on its being received, for good or for evil, "
+        "in the superlative degree of comparison only. There were a king with a large jaw and a queen with a plain face, "
+        "on the throne of England; there were a king with a large jaw and a queen with a fair face, on the throne of France. "
+        "In both countries it was clearer than crystal to the lords of the State preserves of loaves and fishes, that things "
+        "in general were settled for ever.\n";
+
+    void append_little_endian(benchmarks::Corpus& corpus, u64 value, unsigned nbytes)
+    {
+        for (unsigned i = 0; i != nbytes; ++i)
+        {
+            corpus.push_back(uint8_t(value >> (8 * i)));
+        }
+    }
+}
+
+benchmarks::Corpus benchmarks::uniform_corpus(size_t size, u64 seed)
+{
+    Random random(seed);
+    Corpus result(size);
+
+    for (auto& datum : result)
+    {
+        datum = uint8_t(random.next() >> 56);
+    }
+
+    return result;
+}
+
+benchmarks::Corpus benchmarks::zipf_corpus(size_t size, u64 seed)
+{
+    std::array<double, 256> cumulative;
+    double total = 0;
+
+    for (unsigned k = 0; k != 256; ++k)
+    {
+        total += 1.0 / (k + 1);
+        cumulative[k] = total;
+    }
+
+    Random random(seed);
+    Corpus result(size);
+
+    for (auto& datum : result)
+    {
+        auto target = random.unit() * total;
+        auto it = std::upper_bound(cumulative.begin(), cumulative.end(), target);
+
+        datum = uint8_t(std::min<size_t>(it - cumulative.begin(), 255));
+    }
+
+    return result;
+}
+
+benchmarks::Corpus benchmarks::runs_corpus(size_t size, u64 seed)
+{
+    Random random(seed);
+    Corpus result;
+    result.reserve(size);
+
+    while (result.size() < size)
+    {
+        auto datum = uint8_t(random.below(16));
+        auto length = std::min<size_t>(size - result.size(), 4 + random.below(random.below(2) == 0 ? 16 : 500));
+
+        result.insert(result.end(), length, datum);
+    }
+
+    return result;
+}
+
+benchmarks::Corpus benchmarks::markov_text_corpus(size_t size, u64 seed)
+{
+    // transitions[a] lists every character that follows a in the training text, with repetitions
+    std::vector<std::vector<uint8_t>> transitions(256);
+    auto length = std::strlen(ENGLISH);
+
+    for (size_t i = 0; i != length; ++i)
+    {
+        auto current = uint8_t(ENGLISH[i]);
+        auto next = uint8_t(ENGLISH[(i + 1) % length]);
+
+        transitions[current].push_back(next);
+    }
+
+    Random random(seed);
+    Corpus result;
+    result.reserve(size);
+    auto current = uint8_t(ENGLISH[0]);
+
+    while (result.size() < size)
+    {
+        result.push_back(current);
+
+        auto& successors = transitions[current];
+        current = successors[random.below(successors.size())];
+    }
+
+    return result;
+}
+
+benchmarks::Corpus benchmarks::records_corpus(size_t size, u64 seed)
+{
+    const char* const NAMES[] = { "alpha   ", "bravo   ", "charlie ", "delta   ", "echo    ", "foxtrot " };
+    constexpr size_t RECORD_SIZE = 4 + 2 + 4 + 4 + 8;
+
+    Random random(seed);
+    Corpus result;
+    result.reserve(size + RECORD_SIZE);
+    u64 id = 0;
+    u64 timestamp = 1600000000;
+    u64 value = 1000;
+
+    while (result.size() < size)
+    {
+        timestamp += random.below(60);
+        value = value + random.below(21) - 10;
+
+        append_little_endian(result, id++, 4);
+        append_little_endian(result, random.below(5), 2);
+        append_little_endian(result, timestamp, 4);
+        append_little_endian(result, value & 0xFFFFFFFF, 4);
+
+        auto name = NAMES[random.below(6)];
+        result.insert(result.end(), name, name + 8);
+    }
+
+    result.resize(size);
+
+    return result;
+}
+
+std::vector<benchmarks::NamedCorpus> benchmarks::standard_corpora(size_t size, u64 seed)
+{
+    return std::vector<NamedCorpus> {
+        NamedCorpus{ "uniform", uniform_corpus(size, seed) },
+        NamedCorpus{ "zipf", zipf_corpus(size, seed) },
+        NamedCorpus{ "runs", runs_corpus(size, seed) },
+        NamedCorpus{ "markov-text", markov_text_corpus(size, seed) },
+        NamedCorpus{ "records", records_corpus(size, seed) },
+    };
+}
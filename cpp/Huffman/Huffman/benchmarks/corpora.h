@@ -0,0 +1,41 @@
+#ifndef CORPORA_H
+#define CORPORA_H
+
+#include "util.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace benchmarks
+{
+    // Synthetic inputs for benchmarking. Every generator is deterministic for a given seed on all platforms,
+    // so results of different builds are comparable
+
+    typedef std::vector<uint8_t> Corpus;
+
+    struct NamedCorpus
+    {
+        std::string name;
+        Corpus data;
+    };
+
+    // Every byte equally likely: incompressible
+    Corpus uniform_corpus(size_t size, u64 seed);
+
+    // Byte k has probability proportional to 1 / (k + 1)
+    Corpus zipf_corpus(size_t size, u64 seed);
+
+    // Runs of a few up to hundreds of equal bytes
+    Corpus runs_corpus(size_t size, u64 seed);
+
+    // Character-level Markov chain trained on a paragraph of English
+    Corpus markov_text_corpus(size_t size, u64 seed);
+
+    // Little-endian fixed-size records with counters, timestamps, enumerations and names
+    Corpus records_corpus(size_t size, u64 seed);
+
+    std::vector<NamedCorpus> standard_corpora(size_t size, u64 seed);
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifdef BENCHMARK_BUILD
+
+#include "benchmarks/allocation-counter.h"
+#include "benchmarks/benchmark.h"
+#include "benchmarks/corpora.h"
+#include "benchmarks/perf-counters.h"
+#include "encoding/encodings.h"
+#include "encoding/fused/fused.h"
+#include "encoding/instrumentation.h"
+#include "encoding/predictive/oracles.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+using namespace encoding;
+
+namespace
+{
+    // Every corpus trains its own codebook, registered under consecutive IDs
+    constexpr u64 FIRST_CODEBOOK_ID = 1;
+
+    struct Options
+    {
+        size_t corpus_size = 64 * 1024;
+        unsigned repetitions = 3;
+        u64 seed = 1;
+        std::string output = "benchmark-results.json";
+        std::string filter;
+        bool counters = false;
+    };
+
+    void usage()
+    {
+        std::cerr << "Usage: benchmarks [--size BYTES] [--repetitions N] [--seed N] [--output FILE] [--filter SUBSTRING] [--counters]\n";
+    }
+
+    bool parse(int argc, char** argv, Options* options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string flag = argv[i];
+
+            if (flag == "--counters")
+            {
+                options->counters = true;
+                continue;
+            }
+
+            if (i + 1 == argc)
+            {
+                return false;
+            }
+
+            std::string value = argv[++i];
+
+            if (flag == "--size") options->corpus_size = size_t(std::strtoull(value.c_str(), nullptr, 10));
+            else if (flag == "--repetitions") options->repetitions = unsigned(std::strtoul(value.c_str(), nullptr, 10));
+            else if (flag == "--seed") options->seed = std::strtoull(value.c_str(), nullptr, 10);
+            else if (flag == "--output") options->output = value;
+            else if (flag == "--filter") options->filter = value;
+            else return false;
+        }
+
+        return options->repetitions > 0;
+    }
+
+    class Runner
+    {
+    private:
+        const Options& m_options;
+        std::vector<benchmarks::Result> m_results;
+        std::unique_ptr<benchmarks::PerfCounters> m_counters;
+
+    public:
+        Runner(const Options& options) : m_options(options)
+        {
+            if (options.counters)
+            {
+                m_counters = std::make_unique<benchmarks::PerfCounters>();
+
+                if (!m_counters->any_available())
+                {
+                    std::cerr << "No hardware performance counters available" << std::endl;
+                }
+            }
+        }
+
+        template<u64 OUT>
+        void run(const std::string& name, Encoding<256, OUT> encoding, const benchmarks::NamedCorpus& corpus, std::shared_ptr<instrumentation::Recorder> recorder = nullptr)
+        {
+            if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos)
+            {
+                return;
+            }
+
+            std::cerr << corpus.name << " / " << name << std::endl;
+            m_results.push_back(benchmarks::measure(name, encoding, corpus, m_options.repetitions, recorder, m_counters.get()));
+        }
+
+        const std::vector<benchmarks::Result>& results() const
+        {
+            return m_results;
+        }
+    };
+
+    void run_stages(Runner& runner, const benchmarks::NamedCorpus& corpus, u64 codebook_id)
+    {
+        runner.run("eof", eof_encoding<256>(), corpus);
+        runner.run("move-to-front", move_to_front<256>(), corpus);
+        runner.run("move-to-front-fast", move_to_front_fast<256>(), corpus);
+        runner.run("huffman", huffman_encoding<256>(), corpus);
+        runner.run("adaptive-huffman", adaptive_huffman<256>(), corpus);
+        runner.run("static-huffman", static_huffman_encoding<256>(codebook_id), corpus);
+        runner.run("rans", rans_encoding<256>(), corpus);
+        runner.run("adaptive-range", adaptive_range_encoding<256>(), corpus);
+        runner.run("lz77", lz77<256>(), corpus);
+        runner.run("predictive-trie", predictive_encoding<256>([]() { return predictive::trie_oracle(3); }), corpus);
+        runner.run("predictive-hashed", predictive_encoding<256>([]() { return predictive::hashed_context_oracle(3, 16); }), corpus);
+        runner.run("predictive-mixing", predictive_encoding<256>([]() { return predictive::mixing_oracle(3, 16); }), corpus);
+    }
+
+    void run_pipelines(Runner& runner, const benchmarks::NamedCorpus& corpus)
+    {
+        auto recorder = std::make_shared<instrumentation::Recorder>();
+
+        runner.run("mtf|eof|huffman|bits",
+            instrumented(move_to_front<256>(), "move-to-front", recorder)
+            | instrumented(eof_encoding<256>(), "eof", recorder)
+            | instrumented(huffman_encoding<257>(), "huffman", recorder)
+            | instrumented(bit_grouper<8>(), "bit-grouper", recorder),
+            corpus, recorder);
+
+        runner.run("stored(mtf|eof|huffman)|bits",
+            stored_fallback(move_to_front<256>() | eof_encoding<256>() | huffman_encoding<257>()) | bit_grouper<8>(),
+            corpus);
+
+        runner.run("predictive|eof|adaptive-huffman|bits",
+            instrumented(predictive_encoding<256>([]() { return predictive::trie_oracle(5); }), "predictive", recorder)
+            | instrumented(eof_encoding<256>(), "eof", recorder)
+            | instrumented(adaptive_huffman<257>(), "adaptive-huffman", recorder)
+            | instrumented(bit_grouper<8>(), "bit-grouper", recorder),
+            corpus, recorder);
+
+        runner.run("lz77|rans",
+            instrumented(lz77<256>(), "lz77", recorder)
+            | instrumented(rans_encoding<257>(), "rans", recorder),
+            corpus, recorder);
+
+        runner.run("fused eof|adaptive-huffman|bits", fused::to_encoding(fused::eof<256> | fused::adaptive_huffman<257> | fused::bit_grouper<8>), corpus);
+        runner.run("lazy eof|adaptive-huffman|bits", fused::to_lazy_encoding(fused::eof<256> | fused::adaptive_huffman<257> | fused::bit_grouper<8>), corpus);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (!parse(argc, argv, &options))
+    {
+        usage();
+        return 1;
+    }
+
+    benchmarks::install_allocation_probe();
+
+    Runner runner(options);
+
+    u64 codebook_id = FIRST_CODEBOOK_ID;
+
+    for (auto& corpus : benchmarks::standard_corpora(options.corpus_size, options.seed))
+    {
+        std::vector<Datum> training(corpus.data.begin(), corpus.data.end());
+
+        if (!huffman::register_codebook(codebook_id, huffman::train_codebook(training, 256)))
+        {
+            std::cerr << "Codebook ID " << codebook_id << " is already in use" << std::endl;
+            return 1;
+        }
+
+        run_stages(runner, corpus, codebook_id++);
+        run_pipelines(runner, corpus);
+    }
+
+    benchmarks::print(runner.results(), std::cout);
+    std::cout << '\n';
+    benchmarks::print_allocation_budget(runner.results(), std::cout);
+
+    std::ofstream output(options.output);
+    output << benchmarks::to_json(runner.results()) << '\n';
+
+    for (auto& result : runner.results())
+    {
+        if (!result.verified)
+        {
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "benchmarks/perf-counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+
+namespace
+{
+    const char* const NAMES[] = { "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses" };
+
+    static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == benchmarks::COUNTER_COUNT, "Every counter needs a name");
+
+#ifdef __linux__
+    u64 cache_miss(u64 cache)
+    {
+        return cache | (u64(PERF_COUNT_HW_CACHE_OP_READ) << 8) | (u64(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+    }
+
+    int open_counter(benchmarks::Counter counter)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+
+        attributes.size = sizeof(attributes);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (counter)
+        {
+        case benchmarks::Counter::CYCLES:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+
+        case benchmarks::Counter::INSTRUCTIONS:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+
+        case benchmarks::Counter::BRANCH_MISSES:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+
+        case benchmarks::Counter::L1D_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = cache_miss(PERF_COUNT_HW_CACHE_L1D);
+            break;
+
+        case benchmarks::Counter::LLC_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+            break;
+
+        case benchmarks::Counter::DTLB_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = cache_miss(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        }
+
+        // This thread, any CPU, no group
+        return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+#endif
+}
+
+const char* benchmarks::counter_name(Counter counter)
+{
+    return NAMES[size_t(counter)];
+}
+
+#ifdef __linux__
+
+benchmarks::PerfCounters::PerfCounters()
+{
+    m_enabled_at_start.fill(0);
+    m_running_at_start.fill(0);
+
+    for (size_t i = 0; i != COUNTER_COUNT; ++i)
+    {
+        m_descriptors[i] = open_counter(Counter(i));
+    }
+}
+
+benchmarks::PerfCounters::~PerfCounters()
+{
+    for (auto descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+}
+
+void benchmarks::PerfCounters::start()
+{
+    for (size_t i = 0; i != COUNTER_COUNT; ++i)
+    {
+        // value, time enabled, time running
+        u64 data[3];
+
+        m_enabled_at_start[i] = 0;
+        m_running_at_start[i] = 0;
+
+        if (m_descriptors[i] >= 0)
+        {
+            ioctl(m_descriptors[i], PERF_EVENT_IOC_RESET, 0);
+
+            if (read(m_descriptors[i], data, sizeof(data)) == ssize_t(sizeof(data)))
+            {
+                m_enabled_at_start[i] = data[1];
+                m_running_at_start[i] = data[2];
+            }
+        }
+    }
+
+    for (auto descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+benchmarks::CounterValues benchmarks::PerfCounters::stop()
+{
+    CounterValues result;
+
+    for (auto descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i != COUNTER_COUNT; ++i)
+    {
+        // value, time enabled, time running
+        u64 data[3];
+
+        result.values[i] = 0;
+        result.available[i] = false;
+
+        if (m_descriptors[i] >= 0 && read(m_descriptors[i], data, sizeof(data)) == ssize_t(sizeof(data)))
+        {
+            auto enabled = data[1] - m_enabled_at_start[i];
+            auto running = data[2] - m_running_at_start[i];
+
+            if (running > 0)
+            {
+                result.values[i] = double(data[0]) * double(enabled) / double(running);
+                result.available[i] = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+#else
+
+benchmarks::PerfCounters::PerfCounters()
+{
+    m_descriptors.fill(-1);
+    m_enabled_at_start.fill(0);
+    m_running_at_start.fill(0);
+}
+
+benchmarks::PerfCounters::~PerfCounters()
+{
+    // NOP
+}
+
+void benchmarks::PerfCounters::start()
+{
+    // NOP
+}
+
+benchmarks::CounterValues benchmarks::PerfCounters::stop()
+{
+    CounterValues result;
+
+    result.values.fill(0);
+    result.available.fill(false);
+
+    return result;
+}
+
+#endif
+
+bool benchmarks::PerfCounters::any_available() const
+{
+    for (auto descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
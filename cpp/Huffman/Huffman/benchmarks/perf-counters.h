@@ -0,0 +1,56 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "util.h"
+#include <array>
+#include <cstddef>
+
+
+namespace benchmarks
+{
+    enum class Counter { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES, LLC_MISSES, DTLB_MISSES };
+
+    constexpr size_t COUNTER_COUNT = 6;
+
+    const char* counter_name(Counter counter);
+
+    struct CounterValues
+    {
+        std::array<double, COUNTER_COUNT> values;
+        std::array<bool, COUNTER_COUNT> available;
+
+        double operator [](Counter counter) const
+        {
+            return values[size_t(counter)];
+        }
+    };
+
+    // Hardware performance counters of the calling thread, read through perf_event_open on Linux.
+    // Counters the kernel or the hardware does not provide (e.g. inside most virtual machines, or when
+    // perf_event_paranoid forbids it) are marked unavailable; elsewhere no counter is available at all
+    class PerfCounters
+    {
+    private:
+        std::array<int, COUNTER_COUNT> m_descriptors;
+
+        // Resetting a counter leaves its enabled and running times untouched, so they are recorded at start
+        std::array<u64, COUNTER_COUNT> m_enabled_at_start;
+        std::array<u64, COUNTER_COUNT> m_running_at_start;
+
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator =(const PerfCounters&) = delete;
+
+        bool any_available() const;
+
+        void start();
+
+        // Counts since start. When the kernel multiplexes counters, values are scaled to the full interval
+        CounterValues stop();
+    };
+}
+
+#endif
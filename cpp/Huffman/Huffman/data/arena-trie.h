@@ -0,0 +1,183 @@
+#ifndef ARENA_TRIE_H
+#define ARENA_TRIE_H
+
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+
+namespace data
+{
+    // Trie with a fixed node capacity. Nodes live in one contiguous array and are referred to by index.
+    // Children are located through a single open addressing table keyed on (parent, key),
+    // so no memory is allocated after construction.
+    template<typename T, typename U>
+    class ArenaTrie
+    {
+    public:
+        typedef uint32_t node;
+
+        static constexpr node root = 0;
+        static constexpr node none = std::numeric_limits<node>::max();
+
+    private:
+        struct Node
+        {
+            U data;
+            node maximum;
+            T maximum_key;
+        };
+
+        struct Slot
+        {
+            node parent;
+            node child;
+            T key;
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<Slot> m_slots;
+        size_t m_capacity;
+
+    public:
+        ArenaTrie(size_t capacity) : m_capacity(capacity)
+        {
+            assert(capacity > 0);
+            assert(capacity < none);
+
+            size_t slot_count = 1;
+
+            while (slot_count < 2 * capacity)
+            {
+                slot_count *= 2;
+            }
+
+            m_nodes.reserve(capacity);
+            m_slots.resize(slot_count);
+            clear();
+        }
+
+        // Largest capacity whose nodes and slots fit in the given number of bytes
+        static size_t capacity_for_budget(size_t bytes)
+        {
+            size_t slot_count = 2;
+
+            while ((2 * slot_count) * sizeof(Slot) + slot_count * sizeof(Node) <= bytes)
+            {
+                slot_count *= 2;
+            }
+
+            return slot_count / 2;
+        }
+
+        size_t size() const
+        {
+            return m_nodes.size();
+        }
+
+        size_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        void clear()
+        {
+            m_nodes.clear();
+            m_nodes.push_back(create_node());
+            std::fill(m_slots.begin(), m_slots.end(), Slot{ none, none, T() });
+        }
+
+        node find(node parent, const T& key) const
+        {
+            auto& slot = m_slots[locate(parent, key)];
+
+            return slot.child;
+        }
+
+        // Returns the child, creating it if necessary, or none if the trie is full
+        node child(node parent, const T& key)
+        {
+            auto index = locate(parent, key);
+            auto& slot = m_slots[index];
+
+            if (slot.child == none)
+            {
+                if (m_nodes.size() == m_capacity)
+                {
+                    return none;
+                }
+
+                slot = Slot{ parent, node(m_nodes.size()), key };
+                m_nodes.push_back(create_node());
+            }
+
+            return slot.child;
+        }
+
+        U& data(node n)
+        {
+            return m_nodes[n].data;
+        }
+
+        const U& data(node n) const
+        {
+            return m_nodes[n].data;
+        }
+
+        bool has_children(node n) const
+        {
+            return m_nodes[n].maximum != none;
+        }
+
+        // Same contract as Trie::update_maximum
+        void update_maximum(node parent, node child, const T& key)
+        {
+            auto& p = m_nodes[parent];
+
+            if (p.maximum == none || m_nodes[p.maximum].data < m_nodes[child].data || (!(m_nodes[child].data < m_nodes[p.maximum].data) && key < p.maximum_key))
+            {
+                p.maximum = child;
+                p.maximum_key = key;
+            }
+        }
+
+        const T& maximum_key(node n) const
+        {
+            assert(has_children(n));
+
+            return m_nodes[n].maximum_key;
+        }
+
+    private:
+        static Node create_node()
+        {
+            return Node{ U(), none, T() };
+        }
+
+        size_t locate(node parent, const T& key) const
+        {
+            auto mask = m_slots.size() - 1;
+            u64 h = (u64(parent) * 0x9E3779B97F4A7C15ull) ^ u64(std::hash<T>()(key));
+            auto index = size_t((h * 0xC2B2AE3D27D4EB4Full) >> 32) & mask;
+
+            while (m_slots[index].child != none && (m_slots[index].parent != parent || m_slots[index].key != key))
+            {
+                index = (index + 1) & mask;
+            }
+
+            return index;
+        }
+    };
+
+    template<typename T, typename U>
+    constexpr typename ArenaTrie<T, U>::node ArenaTrie<T, U>::root;
+
+    template<typename T, typename U>
+    constexpr typename ArenaTrie<T, U>::node ArenaTrie<T, U>::none;
+}
+
+#endif
@@ -2,9 +2,11 @@
 #define BINARY_TREE_H
 
 #include "util.h"
-#include <functional>
 #include <assert.h>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace data
 {
@@ -28,16 +30,39 @@ namespace data
     class Branch : public Node<T>
     {
     private:
-        const std::unique_ptr<const Node<T>> m_left_child;
-        const std::unique_ptr<const Node<T>> m_right_child;
+        std::unique_ptr<Node<T>> m_left_child;
+        std::unique_ptr<Node<T>> m_right_child;
 
     public:
-        Branch(std::unique_ptr<const Node<T>> left_child, std::unique_ptr<const Node<T>> right_child) : m_left_child(std::move(left_child)), m_right_child(std::move(right_child))
+        Branch(std::unique_ptr<Node<T>> left_child, std::unique_ptr<Node<T>> right_child) : m_left_child(std::move(left_child)), m_right_child(std::move(right_child))
         {
             assert(m_left_child != nullptr);
             assert(m_right_child != nullptr);
         }
 
+        Branch(const Branch&) = delete;
+        Branch& operator =(const Branch&) = delete;
+
+        // Descendants are taken from the branches they belong to before being deleted,
+        // so that deep trees are destroyed without recursion
+        ~Branch()
+        {
+            std::vector<std::unique_ptr<Node<T>>> stack;
+
+            take_children(stack);
+
+            while (!stack.empty())
+            {
+                auto node = std::move(stack.back());
+                stack.pop_back();
+
+                if (node->is_branch())
+                {
+                    static_cast<Branch<T>*>(node.get())->take_children(stack);
+                }
+            }
+        }
+
         const Node<T>& left_child() const
         {
             return *this->m_left_child;
@@ -64,6 +89,16 @@ namespace data
         {
             return true;
         }        
+
+    private:
+        void take_children(std::vector<std::unique_ptr<Node<T>>>& stack)
+        {
+            if (m_left_child != nullptr)
+            {
+                stack.push_back(std::move(m_left_child));
+                stack.push_back(std::move(m_right_child));
+            }
+        }
     };
 
     template<typename T>
@@ -101,26 +136,92 @@ namespace data
         }
     };
 
-    // Needs to be external function because of OUT type parameter
-    // It is impossible to create a template virtual method
-    template<typename IN, typename OUT>
-    std::unique_ptr<Node<OUT>> map(const Node<IN>& tree, std::function<OUT(const IN&)> function)
+    // Combines the values of a tree bottom up: leaf(value) is called for every leaf and branch(left, right)
+    // for every branch with the results of its children, left to right. Returns the result for the root.
+    // Uses an explicit stack, so that deep trees do not overflow the call stack
+    template<typename T, typename LEAF, typename BRANCH>
+    auto fold(const Node<T>& tree, LEAF leaf, BRANCH branch) -> typename std::decay<decltype(leaf(std::declval<const T&>()))>::type
     {
-        if (tree.is_leaf())
+        typedef typename std::decay<decltype(leaf(std::declval<const T&>()))>::type R;
+
+        struct Frame
         {
-            auto& leaf = static_cast<const Leaf<IN>&>(tree);
+            const Node<T>* node;
+            bool children_done;
+        };
+
+        std::vector<Frame> stack{ Frame{ &tree, false } };
+        std::vector<R> results;
+
+        while (!stack.empty())
+        {
+            auto frame = stack.back();
+            stack.pop_back();
+
+            if (frame.node->is_leaf())
+            {
+                results.push_back(leaf(static_cast<const Leaf<T>*>(frame.node)->value()));
+            }
+            else if (frame.children_done)
+            {
+                auto right = std::move(results.back());
+                results.pop_back();
+                auto left = std::move(results.back());
+                results.pop_back();
+
+                results.push_back(branch(std::move(left), std::move(right)));
+            }
+            else
+            {
+                auto b = static_cast<const Branch<T>*>(frame.node);
 
-            return std::make_unique<Leaf<OUT>>(function(leaf.value()));
+                stack.push_back(Frame{ frame.node, true });
+                stack.push_back(Frame{ &b->right_child(), false });
+                stack.push_back(Frame{ &b->left_child(), false });
+            }
         }
-        else
+
+        assert(results.size() == 1);
+
+        return std::move(results.back());
+    }
+
+    // Calls visit(value) for every leaf, left to right
+    template<typename T, typename VISITOR>
+    void visit_leaves(const Node<T>& tree, VISITOR visit)
+    {
+        std::vector<const Node<T>*> stack{ &tree };
+
+        while (!stack.empty())
         {
-            auto& branch = static_cast<const Branch<IN>&>(tree);
-            auto left = map(branch.left_child(), function);
-            auto right = map(branch.right_child(), function);
+            auto node = stack.back();
+            stack.pop_back();
 
-            return std::make_unique<Branch<OUT>>(std::move(left), std::move(right));
+            if (node->is_leaf())
+            {
+                visit(static_cast<const Leaf<T>*>(node)->value());
+            }
+            else
+            {
+                auto branch = static_cast<const Branch<T>*>(node);
+
+                stack.push_back(&branch->right_child());
+                stack.push_back(&branch->left_child());
+            }
         }
     }
+
+    // Needs to be external function because of OUT type parameter
+    // It is impossible to create a template virtual method
+    template<typename IN, typename OUT, typename FUNCTION>
+    std::unique_ptr<Node<OUT>> map(const Node<IN>& tree, FUNCTION function)
+    {
+        typedef std::unique_ptr<Node<OUT>> node;
+
+        return fold(tree,
+            [&](const IN& value) -> node { return std::make_unique<Leaf<OUT>>(function(value)); },
+            [](node left, node right) -> node { return std::make_unique<Branch<OUT>>(std::move(left), std::move(right)); });
+    }
 }
 
 #endif
@@ -0,0 +1,210 @@
+#ifndef CONTEXT_TABLE_H
+#define CONTEXT_TABLE_H
+
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace data
+{
+    // Fixed-size, direct-mapped table that associates a predicted datum with a context hash.
+    // Colliding contexts simply evict each other; a 16 bit checksum detects most collisions.
+    // The slots are laid out so that each lookup touches a single cache line.
+    class ContextTable
+    {
+    public:
+        struct Slot
+        {
+            uint16_t checksum;
+            uint16_t confidence;
+            uint32_t prediction;
+        };
+
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+        static constexpr uint16_t MAX_CONFIDENCE = 255;
+
+        // Indices come from the low bits of the hash and checksums from its top 16 bits; beyond this, tables would not fit in memory anyway
+        static constexpr unsigned MAX_TABLE_BITS = 32;
+
+        static constexpr size_t SLOTS_PER_LINE = CACHE_LINE_SIZE / sizeof(Slot);
+
+    private:
+        std::unique_ptr<Slot[]> m_storage;
+        Slot* m_slots;
+        u64 m_mask;
+
+        // Optional read-only initial contents (e.g. a memory mapped pretrained model). Lines are
+        // copied into m_slots the first time they are written to, and clear() forgets those copies
+        const Slot* m_base;
+        std::vector<bool> m_copied_lines;
+        std::vector<size_t> m_touched_lines;
+
+    public:
+        ContextTable(unsigned table_bits) : ContextTable(table_bits, nullptr)
+        {
+            // NOP
+        }
+
+        // base must hold 2^table_bits slots and remain valid for the lifetime of the table
+        ContextTable(unsigned table_bits, const Slot* base) : m_storage(new Slot[slot_count(table_bits) + SLOTS_PER_LINE]), m_mask(slot_count(table_bits) - 1), m_base(base)
+        {
+            static_assert(sizeof(Slot) == 8, "Slots should pack evenly into cache lines");
+
+            // Left uninitialized so that pages are only touched once used
+            auto address = reinterpret_cast<uintptr_t>(m_storage.get());
+            auto misalignment = address % CACHE_LINE_SIZE;
+            m_slots = m_storage.get() + (misalignment == 0 ? 0 : (CACHE_LINE_SIZE - misalignment) / sizeof(Slot));
+
+            if (m_base != nullptr)
+            {
+                m_copied_lines.resize((size() + SLOTS_PER_LINE - 1) / SLOTS_PER_LINE, false);
+            }
+
+            clear();
+        }
+
+        ContextTable(const ContextTable&) = delete;
+        ContextTable& operator =(const ContextTable&) = delete;
+
+        size_t size() const
+        {
+            return size_t(m_mask + 1);
+        }
+
+        // Contents of a table without base, suitable for saving and later passing as base
+        const Slot* slots() const
+        {
+            assert(m_base == nullptr);
+
+            return m_slots;
+        }
+
+        // Restores the initial contents: all empty, or the base
+        void clear()
+        {
+            if (m_base == nullptr)
+            {
+                std::fill(m_slots, m_slots + size(), Slot{ 0, 0, 0 });
+            }
+            else
+            {
+                for (auto line : m_touched_lines)
+                {
+                    m_copied_lines[line] = false;
+                }
+
+                m_touched_lines.clear();
+            }
+        }
+
+        // Returns true if the context has been seen before, in which case *prediction is set to the datum
+        // that followed it and *confidence to how well that prediction has held up
+        bool lookup(u64 hash, Datum* prediction, unsigned* confidence) const
+        {
+            hash = mix(hash);
+            auto& slot = read(index(hash));
+
+            if (slot.confidence > 0 && slot.checksum == checksum(hash))
+            {
+                *prediction = slot.prediction;
+                *confidence = slot.confidence;
+                return true;
+            }
+
+            return false;
+        }
+
+        void update(u64 hash, Datum actual)
+        {
+            assert(actual <= UINT32_MAX);
+
+            hash = mix(hash);
+            auto& slot = write(index(hash));
+
+            if (slot.confidence > 0 && slot.checksum == checksum(hash))
+            {
+                if (slot.prediction == actual)
+                {
+                    if (slot.confidence < MAX_CONFIDENCE)
+                    {
+                        ++slot.confidence;
+                    }
+                }
+                else if (--slot.confidence == 0)
+                {
+                    slot.prediction = uint32_t(actual);
+                    slot.confidence = 1;
+                }
+            }
+            else
+            {
+                slot = Slot{ checksum(hash), 1, uint32_t(actual) };
+            }
+        }
+
+    private:
+        static u64 mix(u64 hash)
+        {
+            hash ^= hash >> 31;
+            hash *= 0x7FB5D329728EA185ull;
+            hash ^= hash >> 27;
+            hash *= 0x81DADEF4BC2DD44Dull;
+            hash ^= hash >> 33;
+
+            return hash;
+        }
+
+        size_t index(u64 hash) const
+        {
+            return size_t(hash & m_mask);
+        }
+
+        const Slot& read(size_t index) const
+        {
+            if (m_base != nullptr && !m_copied_lines[index / SLOTS_PER_LINE])
+            {
+                return m_base[index];
+            }
+
+            return m_slots[index];
+        }
+
+        Slot& write(size_t index)
+        {
+            if (m_base != nullptr)
+            {
+                auto line = index / SLOTS_PER_LINE;
+
+                if (!m_copied_lines[line])
+                {
+                    auto first = line * SLOTS_PER_LINE;
+                    auto last = std::min(first + SLOTS_PER_LINE, size());
+
+                    std::copy(m_base + first, m_base + last, m_slots + first);
+                    m_copied_lines[line] = true;
+                    m_touched_lines.push_back(line);
+                }
+            }
+
+            return m_slots[index];
+        }
+
+        static uint16_t checksum(u64 hash)
+        {
+            return uint16_t(hash >> 48);
+        }
+
+        static size_t slot_count(unsigned table_bits)
+        {
+            assert(table_bits <= MAX_TABLE_BITS);
+
+            return size_t(1) << table_bits;
+        }
+    };
+}
+
+#endif
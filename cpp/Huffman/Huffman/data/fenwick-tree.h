@@ -0,0 +1,126 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace data
+{
+    // Frequency table over the values [0, domain_size) which also
+    // answers cumulative frequency queries, all in O(log domain_size)
+    class FenwickTree
+    {
+    private:
+        // 1-based: m_tree[i] holds the sum of the frequencies of values [i - lowbit(i), i)
+        std::vector<u64> m_tree;
+        u64 m_total;
+
+    public:
+        FenwickTree(u64 domain_size) : m_tree(domain_size + 1, 0), m_total(0)
+        {
+            // NOP
+        }
+
+        u64 domain_size() const
+        {
+            return m_tree.size() - 1;
+        }
+
+        u64 total() const
+        {
+            return m_total;
+        }
+
+        void increment(u64 value)
+        {
+            add(value, 1);
+        }
+
+        void add(u64 value, u64 amount)
+        {
+            assert(value < domain_size());
+
+            for (auto i = value + 1; i < m_tree.size(); i += lowbit(i))
+            {
+                m_tree[i] += amount;
+            }
+
+            m_total += amount;
+        }
+
+        u64 operator[](u64 value) const
+        {
+            return cumulative(value + 1) - cumulative(value);
+        }
+
+        // Sum of the frequencies of all values strictly less than value
+        u64 cumulative(u64 value) const
+        {
+            assert(value <= domain_size());
+
+            u64 result = 0;
+
+            for (auto i = value; i > 0; i -= lowbit(i))
+            {
+                result += m_tree[i];
+            }
+
+            return result;
+        }
+
+        // Finds the value v for which cumulative(v) <= target < cumulative(v + 1)
+        u64 find(u64 target) const
+        {
+            assert(target < m_total);
+
+            u64 position = 0;
+            u64 step = 1;
+
+            while (step * 2 < m_tree.size())
+            {
+                step *= 2;
+            }
+
+            for (; step != 0; step /= 2)
+            {
+                if (position + step < m_tree.size() && m_tree[position + step] <= target)
+                {
+                    position += step;
+                    target -= m_tree[position];
+                }
+            }
+
+            return position;
+        }
+
+        // Divides all frequencies by two, rounding up so that no nonzero frequency drops to zero
+        void halve()
+        {
+            std::vector<u64> frequencies;
+
+            for (u64 value = 0; value != domain_size(); ++value)
+            {
+                frequencies.push_back((*this)[value]);
+            }
+
+            std::fill(m_tree.begin(), m_tree.end(), 0);
+            m_total = 0;
+
+            for (u64 value = 0; value != frequencies.size(); ++value)
+            {
+                add(value, (frequencies[value] + 1) / 2);
+            }
+        }
+
+    private:
+        static u64 lowbit(u64 i)
+        {
+            return i & (~i + 1);
+        }
+    };
+}
+
+#endif
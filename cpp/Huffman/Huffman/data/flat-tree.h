@@ -0,0 +1,151 @@
+#ifndef FLAT_TREE_H
+#define FLAT_TREE_H
+
+#include "data/binary-tree.h"
+#include "util.h"
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+namespace data
+{
+    // Binary tree of Datum stored as an array of child references. A reference to a branch is its index,
+    // a reference to a leaf is the bitwise complement of its datum, so that leaves are exactly the negative references.
+    // Walking the tree needs neither virtual calls nor pointer chasing, and building one needs no allocation per node,
+    // which is why the Huffman coders build and decode their trees as flat trees
+    class FlatTree
+    {
+    public:
+        typedef int32_t node;
+
+    private:
+        // Children of branch i are at 2 * i (left) and 2 * i + 1 (right)
+        std::vector<node> m_children;
+        node m_root;
+
+    public:
+        FlatTree() : m_root(0)
+        {
+            // NOP
+        }
+
+        // Copies a pointer based tree
+        explicit FlatTree(const Node<Datum>& tree) : m_root(0)
+        {
+            m_root = copy(tree);
+        }
+
+        static node leaf(Datum datum)
+        {
+            assert(datum <= Datum(std::numeric_limits<node>::max()));
+
+            return ~node(datum);
+        }
+
+        static bool is_leaf(node n)
+        {
+            return n < 0;
+        }
+
+        static Datum datum(node n)
+        {
+            assert(is_leaf(n));
+
+            return Datum(~n);
+        }
+
+        node root() const
+        {
+            return m_root;
+        }
+
+        node child(node n, Datum bit) const
+        {
+            assert(!is_leaf(n));
+            assert(bit == 0 || bit == 1);
+
+            return m_children[2 * size_t(n) + size_t(bit)];
+        }
+
+        size_t branch_count() const
+        {
+            return m_children.size() / 2;
+        }
+
+        // Children must have been added before their parent
+        node branch(node left_child, node right_child)
+        {
+            assert(is_leaf(left_child) || size_t(left_child) < branch_count());
+            assert(is_leaf(right_child) || size_t(right_child) < branch_count());
+            assert(branch_count() < size_t(std::numeric_limits<node>::max()));
+
+            auto result = node(branch_count());
+            m_children.push_back(left_child);
+            m_children.push_back(right_child);
+
+            return result;
+        }
+
+        void set_root(node root)
+        {
+            assert(is_leaf(root) || size_t(root) < branch_count());
+
+            m_root = root;
+        }
+
+        void clear()
+        {
+            m_children.clear();
+            m_root = 0;
+        }
+
+        // Same shape and leaves; branch numbering is irrelevant
+        bool equal_to(const FlatTree& other) const
+        {
+            std::vector<std::pair<node, node>> stack{ { m_root, other.m_root } };
+
+            while (!stack.empty())
+            {
+                auto [x, y] = stack.back();
+                stack.pop_back();
+
+                if (is_leaf(x) || is_leaf(y))
+                {
+                    if (x != y)
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    stack.emplace_back(child(x, 0), other.child(y, 0));
+                    stack.emplace_back(child(x, 1), other.child(y, 1));
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        node copy(const Node<Datum>& tree)
+        {
+            if (tree.is_leaf())
+            {
+                return leaf(static_cast<const Leaf<Datum>&>(tree).value());
+            }
+            else
+            {
+                auto& b = static_cast<const Branch<Datum>&>(tree);
+                auto left = copy(b.left_child());
+                auto right = copy(b.right_child());
+
+                return branch(left, right);
+            }
+        }
+    };
+}
+
+#endif
@@ -120,6 +120,20 @@ namespace data
 
         return result;
     }
+
+    // Counts a compactly stored vector into a table with a wider value type
+    template<typename U, typename T>
+    data::FrequencyTable<U> count_frequencies_as(const std::vector<T>& xs)
+    {
+        data::FrequencyTable<U> result;
+
+        for (auto& x : xs)
+        {
+            result.increment(U(x));
+        }
+
+        return result;
+    }
 }
 
 #endif
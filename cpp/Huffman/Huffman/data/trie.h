@@ -1,8 +1,10 @@
 #ifndef TRIE_H
 #define TRIE_H
 
+#include <assert.h>
 #include <memory>
 #include <map>
+#include <vector>
 
 
 namespace data
@@ -11,21 +13,28 @@ namespace data
     class Trie
     {
     private:
-        std::map<T, std::unique_ptr<Trie<T, U>>> m_children;
+        typedef std::map<T, std::unique_ptr<Trie<T, U>>> children;
+
+        children m_children;
+
+        // Child with the largest data (smallest key among equals), or nullptr if there are no children
+        const typename children::value_type* m_maximum;
 
     public:
         U data;
 
-        Trie() : data() { }
+        Trie() : m_maximum(nullptr), data() { }
 
         Trie<T, U>& operator[](const T& key)
         {
-            if (!contains(key))
+            auto it = m_children.lower_bound(key);
+
+            if (it == m_children.end() || it->first != key)
             {
-                m_children[key] = std::make_unique<Trie<T, U>>();
+                it = m_children.emplace_hint(it, key, std::make_unique<Trie<T, U>>());
             }
 
-            return *m_children[key];
+            return *it->second;
         }
 
         bool contains(const T& key) const
@@ -33,6 +42,42 @@ namespace data
             return m_children.find(key) != m_children.end();
         }
 
+        bool has_children() const
+        {
+            return !m_children.empty();
+        }
+
+        // Must be called after the data of a child has increased so that maximum_key stays correct.
+        // Data is assumed to never decrease
+        void update_maximum(const T& key)
+        {
+            auto it = m_children.find(key);
+            assert(it != m_children.end());
+
+            auto& candidate = *it;
+
+            if (m_maximum == nullptr || m_maximum->second->data < candidate.second->data || (!(candidate.second->data < m_maximum->second->data) && candidate.first < m_maximum->first))
+            {
+                m_maximum = &candidate;
+            }
+        }
+
+        const T& maximum_key() const
+        {
+            assert(m_maximum != nullptr);
+
+            return m_maximum->first;
+        }
+
+        template<typename F>
+        void for_each_child(F function) const
+        {
+            for (auto it = m_children.begin(); it != m_children.end(); ++it)
+            {
+                function(it->first, *it->second);
+            }
+        }
+
         std::vector<T> keys() const
         {
             std::vector<T> result;
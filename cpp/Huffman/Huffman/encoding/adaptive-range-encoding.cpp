@@ -0,0 +1,212 @@
+#include "encoding/adaptive-range-encoding.h"
+#include "data/fenwick-tree.h"
+#include "io/binary-io.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+
+
+namespace
+{
+    // Carryless range coder (Subbotin): bytes are shifted out as soon as the
+    // top byte of low is settled, or the range is forcibly shrunk when it gets too small
+    constexpr uint32_t TOP = uint32_t(1) << 24;
+    constexpr uint32_t BOTTOM = uint32_t(1) << 16;
+
+    // Total frequency must stay at most BOTTOM so that range / total never becomes zero
+    constexpr u64 MAX_TOTAL = BOTTOM;
+    constexpr u64 INCREMENT = 32;
+
+    class RangeEncoder
+    {
+    private:
+        io::OutputStream& m_output;
+        uint32_t m_low;
+        uint32_t m_range;
+
+    public:
+        RangeEncoder(io::OutputStream& output) : m_output(output), m_low(0), m_range(0xFFFFFFFF)
+        {
+            // NOP
+        }
+
+        void encode(uint32_t cumulative, uint32_t frequency, uint32_t total)
+        {
+            m_range /= total;
+            m_low += cumulative * m_range;
+            m_range *= frequency;
+
+            while ((m_low ^ (m_low + m_range)) < TOP || (m_range < BOTTOM && ((m_range = (0 - m_low) & (BOTTOM - 1)), true)))
+            {
+                m_output.write(m_low >> 24);
+                m_low <<= 8;
+                m_range <<= 8;
+            }
+        }
+
+        void flush()
+        {
+            for (unsigned i = 0; i != 4; ++i)
+            {
+                m_output.write(m_low >> 24);
+                m_low <<= 8;
+            }
+        }
+    };
+
+    class RangeDecoder
+    {
+    private:
+        io::InputStream& m_input;
+        uint32_t m_low;
+        uint32_t m_range;
+        uint32_t m_code;
+        bool m_exhausted;
+
+    public:
+        RangeDecoder(io::InputStream& input) : m_input(input), m_low(0), m_range(0xFFFFFFFF), m_code(0), m_exhausted(false)
+        {
+            for (unsigned i = 0; i != 4; ++i)
+            {
+                shift_in();
+            }
+        }
+
+        // The decoder reads exactly the bytes the encoder wrote, so needing more means the data were cut short
+        bool exhausted() const
+        {
+            return m_exhausted;
+        }
+
+        uint32_t peek(uint32_t total)
+        {
+            m_range /= total;
+            auto result = (m_code - m_low) / m_range;
+
+            return result < total ? result : total - 1;
+        }
+
+        void consume(uint32_t cumulative, uint32_t frequency)
+        {
+            m_low += cumulative * m_range;
+            m_range *= frequency;
+
+            while ((m_low ^ (m_low + m_range)) < TOP || (m_range < BOTTOM && ((m_range = (0 - m_low) & (BOTTOM - 1)), true)))
+            {
+                shift_in();
+                m_low <<= 8;
+                m_range <<= 8;
+            }
+        }
+
+    private:
+        void shift_in()
+        {
+            m_exhausted = m_exhausted || m_input.end_reached();
+            m_code = (m_code << 8) | uint32_t(io::read_bytes(1, m_input));
+        }
+    };
+
+    class AdaptiveRangeEncodingImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        u64 m_domain_size;
+        Datum m_eof;
+
+    public:
+        AdaptiveRangeEncodingImplementation(u64 domain_size) : m_domain_size(domain_size), m_eof(domain_size)
+        {
+            assert(domain_size + 1 <= MAX_TOTAL / 2);
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            auto frequencies = create_initial_frequencies();
+            RangeEncoder encoder(output);
+
+            while (!input.end_reached())
+            {
+                auto datum = input.read();
+                assert(datum < m_domain_size);
+
+                encode_datum(datum, frequencies, encoder);
+                update(datum, frequencies);
+            }
+
+            encode_datum(m_eof, frequencies, encoder);
+            encoder.flush();
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            auto frequencies = create_initial_frequencies();
+            RangeDecoder decoder(input);
+
+            while (true)
+            {
+                auto total = uint32_t(frequencies.total());
+                auto datum = frequencies.find(decoder.peek(total));
+                decoder.consume(uint32_t(frequencies.cumulative(datum)), uint32_t(frequencies[datum]));
+
+                if (datum == m_eof)
+                {
+                    return;
+                }
+
+                if (decoder.exhausted())
+                {
+                    input.fail();
+                    return;
+                }
+
+                output.write(datum);
+                update(datum, frequencies);
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            // Per datum (and EOF), the range shrinks by at most a factor 2 * MAX_TOTAL for the frequency
+            // (range / total loses up to half) and another BOTTOM when it is forcibly shrunk: 33 bits.
+            // The final range and flush add at most 8 bytes
+            return ((input_size + 1) * 33 + 7) / 8 + 8;
+        }
+
+    private:
+        data::FenwickTree create_initial_frequencies() const
+        {
+            data::FenwickTree frequencies(m_domain_size + 1);
+
+            // Every datum needs a nonzero frequency, so no escape symbol is needed
+            for (u64 datum = 0; datum != m_domain_size + 1; ++datum)
+            {
+                frequencies.increment(datum);
+            }
+
+            return frequencies;
+        }
+
+        void encode_datum(Datum datum, const data::FenwickTree& frequencies, RangeEncoder& encoder) const
+        {
+            auto cumulative = frequencies.cumulative(datum);
+            auto frequency = frequencies[datum];
+
+            encoder.encode(uint32_t(cumulative), uint32_t(frequency), uint32_t(frequencies.total()));
+        }
+
+        void update(Datum datum, data::FenwickTree& frequencies) const
+        {
+            frequencies.add(datum, INCREMENT);
+
+            if (frequencies.total() > MAX_TOTAL)
+            {
+                frequencies.halve();
+            }
+        }
+    };
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_adaptive_range_implementation(u64 domain_size)
+{
+    return std::make_shared<AdaptiveRangeEncodingImplementation>(domain_size);
+}
@@ -0,0 +1,20 @@
+#ifndef ADAPTIVE_RANGE_ENCODING_H
+#define ADAPTIVE_RANGE_ENCODING_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <memory>
+
+
+namespace encoding
+{
+    std::shared_ptr<EncodingImplementation> create_adaptive_range_implementation(u64 domain_size);
+
+    template<u64 IN>
+    Encoding<IN, 256> adaptive_range_encoding()
+    {
+        return encoding::Encoding<IN, 256>(create_adaptive_range_implementation(IN));
+    }
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "encoding/encoding.h"
+#include "encoding/worker-pool.h"
+#include "io/span-streams.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+namespace encoding
+{
+    // Encodes or decodes many small, independent messages at once, spread over several threads,
+    // which are started by the first batch that needs them and kept for the following ones.
+    // Each worker keeps a single pair of streams and appends all of its results to one storage vector,
+    // which is kept (along with its capacity) from one batch to the next.
+    // The returned spans point into that storage and remain valid until the next call
+    template<u64 IN, u64 OUT>
+    class BatchEncoder
+    {
+    public:
+        typedef typename SelectIntegerTypeByDomainSize<IN>::type  decoded_type;
+        typedef typename SelectIntegerTypeByDomainSize<OUT>::type encoded_type;
+
+    private:
+        struct Location
+        {
+            unsigned worker;
+            size_t offset;
+            size_t size;
+        };
+
+        Encoding<IN, OUT> m_encoding;
+        unsigned m_thread_count;
+        std::vector<std::vector<encoded_type>> m_encoded_storage;
+        std::vector<std::vector<decoded_type>> m_decoded_storage;
+        std::vector<Location> m_locations;
+        std::vector<std::span<const encoded_type>> m_encoded;
+        std::vector<std::span<const decoded_type>> m_decoded;
+        std::unique_ptr<WorkerPool> m_workers;
+
+    public:
+        // A thread count of 0 uses one thread per core
+        BatchEncoder(Encoding<IN, OUT> encoding, unsigned thread_count = 0)
+            : m_encoding(encoding), m_thread_count(thread_count != 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency()))
+            , m_encoded_storage(m_thread_count), m_decoded_storage(m_thread_count)
+        {
+            // NOP
+        }
+
+        const std::vector<std::span<const encoded_type>>& encode(const std::vector<std::span<const decoded_type>>& messages)
+        {
+            run(messages, m_encoded_storage, m_encoded, [this](io::InputStream& input, io::OutputStream& output) { m_encoding->encode(input, output); });
+
+            return m_encoded;
+        }
+
+        const std::vector<std::span<const decoded_type>>& decode(const std::vector<std::span<const encoded_type>>& messages)
+        {
+            run(messages, m_decoded_storage, m_decoded, [this](io::InputStream& input, io::OutputStream& output) { m_encoding->decode(input, output); });
+
+            return m_decoded;
+        }
+
+    private:
+        template<typename FROM, typename TO, typename F>
+        void run(const std::vector<std::span<const FROM>>& messages, std::vector<std::vector<TO>>& storage, std::vector<std::span<const TO>>& results, F process)
+        {
+            std::atomic<size_t> next(0);
+            m_locations.resize(messages.size());
+
+            std::function<void(unsigned)> work = [&](unsigned worker) {
+                io::SpanInputStream<FROM> input;
+                io::VectorOutputStream<TO> output(storage[worker]);
+                size_t index;
+
+                storage[worker].clear();
+
+                while ((index = next++) < messages.size())
+                {
+                    auto offset = storage[worker].size();
+
+                    input.reset(messages[index]);
+                    process(input, output);
+                    m_locations[index] = Location{ worker, offset, storage[worker].size() - offset };
+                }
+            };
+
+            if (m_thread_count == 1 || messages.size() <= 1)
+            {
+                work(0);
+            }
+            else
+            {
+                if (!m_workers)
+                {
+                    m_workers = std::make_unique<WorkerPool>(m_thread_count);
+                }
+
+                m_workers->run(work);
+            }
+
+            // Storage may have been reallocated while growing, so spans can only be formed at the very end
+            results.clear();
+
+            for (auto& location : m_locations)
+            {
+                results.emplace_back(storage[location.worker].data() + location.offset, location.size);
+            }
+        }
+    };
+
+    template<u64 IN, u64 OUT>
+    BatchEncoder<IN, OUT> batch(Encoding<IN, OUT> encoding, unsigned thread_count = 0)
+    {
+        return BatchEncoder<IN, OUT>(encoding, thread_count);
+    }
+}
+
+#endif
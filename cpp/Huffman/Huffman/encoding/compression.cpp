@@ -0,0 +1,87 @@
+#include "encoding/compression.h"
+#include "io/span-streams.h"
+#include <assert.h>
+
+
+namespace
+{
+    // The size is written 7 bits at a time, least significant first; the top bit is set on all but the last byte
+    constexpr unsigned MAX_HEADER_SIZE = 10;
+
+    void write_size(u64 size, io::OutputStream& output)
+    {
+        while (size >= 0x80)
+        {
+            output.write((size & 0x7F) | 0x80);
+            size >>= 7;
+        }
+
+        output.write(size);
+    }
+
+    bool read_size(io::SpanInputStream<uint8_t>& input, u64* size)
+    {
+        *size = 0;
+
+        for (unsigned i = 0; i != MAX_HEADER_SIZE; ++i)
+        {
+            if (input.end_reached())
+            {
+                return false;
+            }
+
+            auto b = input.read();
+            *size |= u64(b & 0x7F) << (7 * i);
+
+            if ((b & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+size_t encoding::compress(const Encoding<256, 256>& encoding, std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+    io::SpanInputStream<uint8_t> input_stream(input);
+    io::SpanOutputStream<uint8_t> output_stream(output);
+
+    write_size(input.size(), output_stream);
+    encoding->encode(input_stream, output_stream);
+
+    return output_stream.overflowed() ? COMPRESSION_FAILED : output_stream.size();
+}
+
+size_t encoding::decompress(const Encoding<256, 256>& encoding, std::span<const uint8_t> input, std::span<uint8_t> output)
+{
+    io::SpanInputStream<uint8_t> input_stream(input);
+    u64 size;
+
+    if (!read_size(input_stream, &size) || size > output.size())
+    {
+        return COMPRESSION_FAILED;
+    }
+
+    // Limiting the output to the announced size also catches corrupt data that decode to more
+    io::SpanOutputStream<uint8_t> output_stream(output.first(size_t(size)));
+
+    encoding->decode(input_stream, output_stream);
+
+    if (output_stream.overflowed() || input_stream.failed() || output_stream.size() != size)
+    {
+        return COMPRESSION_FAILED;
+    }
+
+    return output_stream.size();
+}
+
+size_t encoding::max_compressed_size(const Encoding<256, 256>& encoding, size_t input_size)
+{
+    auto result = encoding->max_encoded_size(input_size);
+
+    assert(result != UNBOUNDED);
+
+    return MAX_HEADER_SIZE + size_t(result);
+}
@@ -0,0 +1,28 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <limits>
+#include <span>
+
+
+namespace encoding
+{
+    // Returned by compress and decompress when output is too small or the compressed data are found to be corrupt.
+    // Decoders check what their format lets them check (truncation, impossible values, missing end markers);
+    // other corruption can go unnoticed and decompress to different bytes, but never reads or writes out of bounds
+    constexpr size_t COMPRESSION_FAILED = std::numeric_limits<size_t>::max();
+
+    // One-shot compression of a byte buffer into caller provided memory. No streams or buffers are allocated
+    // on the heap apart from what the encodings themselves need. Both functions return the number of bytes written,
+    // or COMPRESSION_FAILED; max_compressed_size bytes of output always suffice for compression.
+    // Compressed data start with the decompressed size, so that decompress can reject output that is too small
+    // before writing anything
+    size_t compress(const Encoding<256, 256>& encoding, std::span<const uint8_t> input, std::span<uint8_t> output);
+    size_t decompress(const Encoding<256, 256>& encoding, std::span<const uint8_t> input, std::span<uint8_t> output);
+
+    size_t max_compressed_size(const Encoding<256, 256>& encoding, size_t input_size);
+}
+
+#endif
@@ -3,7 +3,8 @@
 
 #include "encoding/encoding.h"
 #include "io/streams.h"
-#include "io/memory-buffer.h"
+#include "io/scratch-buffer.h"
+#include "io/span-streams.h"
 #include <memory>
 
 
@@ -13,6 +14,8 @@ namespace encoding
     class EncodingCombinerImplementation : public encoding::EncodingImplementation
     {
     private:
+        typedef typename SelectIntegerTypeByDomainSize<N2>::type intermediate;
+
         Encoding<N1, N2> m_encoding1;
         Encoding<N2, N3> m_encoding2;
 
@@ -24,18 +27,37 @@ namespace encoding
 
         void encode(io::InputStream& input, io::OutputStream& output) const
         {
-            io::MemoryBuffer<N2> buffer;
+            io::ScratchBuffer<intermediate> buffer;
+            io::VectorOutputStream<intermediate> buffer_output(*buffer);
+
+            m_encoding1->encode(input, buffer_output);
 
-            m_encoding1->encode(input, *buffer.destination()->create_output_stream());
-            m_encoding2->encode(*buffer.source()->create_input_stream(), output);
+            io::SpanInputStream<intermediate> buffer_input(*buffer);
+            m_encoding2->encode(buffer_input, output);
         }
 
         void decode(io::InputStream& input, io::OutputStream& output) const
         {
-            io::MemoryBuffer<N2> buffer;
+            io::ScratchBuffer<intermediate> buffer;
+            io::VectorOutputStream<intermediate> buffer_output(*buffer);
+
+            m_encoding2->decode(input, buffer_output);
+
+            io::SpanInputStream<intermediate> buffer_input(*buffer);
+            m_encoding1->decode(buffer_input, output);
+
+            // The intermediate data come from the input, so their corruption is the input's
+            if (buffer_input.failed())
+            {
+                input.fail();
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            auto intermediate_size = m_encoding1->max_encoded_size(input_size);
 
-            m_encoding2->decode(input, *buffer.destination()->create_output_stream());
-            m_encoding1->decode(*buffer.source()->create_input_stream(), output);
+            return intermediate_size == UNBOUNDED ? UNBOUNDED : m_encoding2->max_encoded_size(intermediate_size);
         }
     };
 
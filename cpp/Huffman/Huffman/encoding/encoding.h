@@ -4,11 +4,15 @@
 #include "io/streams.h"
 #include "io/data-endpoints.h"
 #include "util.h"
+#include <limits>
 #include <memory>
 
 
 namespace encoding
 {
+    // Returned by max_encoded_size when no bound is known
+    constexpr u64 UNBOUNDED = std::numeric_limits<u64>::max();
+
     class EncodingImplementation
     {
     public:
@@ -16,6 +20,9 @@ namespace encoding
 
         virtual void encode(io::InputStream& input, io::OutputStream& output) const = 0;
         virtual void decode(io::InputStream& input, io::OutputStream& output) const = 0;
+
+        // Upper bound on the number of data encode produces for input_size data
+        virtual u64 max_encoded_size(u64 input_size) const = 0;
     };
 
     template<u64 IN, u64 OUT>
@@ -38,6 +45,11 @@ namespace encoding
         {
             return m_implementation.get();
         }
+
+        std::shared_ptr<EncodingImplementation> implementation() const
+        {
+            return m_implementation;
+        }
     };
 
     template<u64 IN, u64 OUT>
@@ -5,9 +5,15 @@
 #include "encoding/move-to-front.h"
 #include "encoding/huffman/huffman-encoding.h"
 #include "encoding/huffman/adaptive-huffman-encoding.h"
+#include "encoding/huffman/static-huffman-encoding.h"
+#include "encoding/huffman/codebook.h"
 #include "encoding/bit-grouper.h"
 #include "encoding/inverter.h"
 #include "encoding/predictive/predictive-encoding.h"
 #include "encoding/eof-encoding.h"
+#include "encoding/rans-encoding.h"
+#include "encoding/adaptive-range-encoding.h"
+#include "encoding/lz77-encoding.h"
+#include "encoding/stored-fallback.h"
 
 #endif
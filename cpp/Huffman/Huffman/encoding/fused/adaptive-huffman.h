@@ -0,0 +1,228 @@
+#ifndef FUSED_ADAPTIVE_HUFFMAN_H
+#define FUSED_ADAPTIVE_HUFFMAN_H
+
+#include "encoding/fused/pipeline.h"
+#include "encoding/huffman/tree-building.h"
+#include "encoding/huffman/code-building.h"
+#include "data/frequency-table.h"
+#include "data/flat-tree.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <memory>
+
+
+namespace encoding
+{
+    namespace fused
+    {
+        // Also behind adaptive_huffman<N>. N is used as EOF and N + 1 as NYT,
+        // which precedes the literal value of a datum that has not been seen yet
+        template<u64 N>
+        struct AdaptiveHuffmanStage : public Fusable
+        {
+            static constexpr u64 input_domain = N;
+            static constexpr u64 output_domain = 2;
+
+            static constexpr Datum EOF_DATUM = N;
+            static constexpr Datum NYT = N + 1;
+            static constexpr unsigned BITS_PER_DATUM = bits_needed(N + 2);
+
+            // EOF and NYT have frequency zero, so the Fibonacci bound does not apply to them directly. But they are merged
+            // first, and that branch next with the lightest datum; treating the result as a single leaf, the rest of the tree
+            // obeys the bound, and no code is more than two longer. Only the first occurrence of a datum needs a literal
+            static u64 max_encoded_size(u64 input_size)
+            {
+                auto distinct = std::min(input_size, N);
+                auto max_length = encoding::huffman::max_code_length(distinct, input_size) + 2;
+
+                return (input_size + 1) * max_length + distinct * BITS_PER_DATUM;
+            }
+
+            template<typename NEXT>
+            class Encoder
+            {
+            private:
+                NEXT m_next;
+                data::FrequencyTable<Datum> m_frequencies;
+                data::FlatTree m_tree;
+                std::vector<Datum> m_code;
+
+            public:
+                Encoder(NEXT next) : m_next(std::move(next)), m_frequencies(create_initial_frequencies())
+                {
+                    // NOP
+                }
+
+                void push(Datum datum)
+                {
+                    assert(datum < N);
+
+                    encoding::huffman::build_flat_tree(m_frequencies, m_tree);
+
+                    if (!push_code(datum))
+                    {
+                        push_code(NYT);
+
+                        for (unsigned i = BITS_PER_DATUM; i-- > 0; )
+                        {
+                            m_next.push((datum >> i) & 1);
+                        }
+                    }
+
+                    m_frequencies.increment(datum);
+                }
+
+                void finish()
+                {
+                    encoding::huffman::build_flat_tree(m_frequencies, m_tree);
+                    push_code(EOF_DATUM);
+                    m_next.finish();
+                }
+
+            private:
+                // Returns false, pushing nothing, if datum has not been seen yet
+                bool push_code(Datum datum)
+                {
+                    if (!encoding::huffman::find_code(m_tree, datum, m_code))
+                    {
+                        return false;
+                    }
+
+                    for (auto bit : m_code)
+                    {
+                        m_next.push(bit);
+                    }
+
+                    return true;
+                }
+            };
+
+            // Bits arrive one at a time, so the decoder keeps track of where it is in the current code
+            template<typename NEXT>
+            class Decoder
+            {
+            private:
+                enum class State { CODE, LITERAL, DONE };
+
+                NEXT m_next;
+                data::FrequencyTable<Datum> m_frequencies;
+                data::FlatTree m_tree;
+                data::FlatTree::node m_current;
+                State m_state;
+                Datum m_literal;
+                unsigned m_literal_bits;
+
+            public:
+                Decoder(NEXT next) : m_next(std::move(next)), m_frequencies(create_initial_frequencies()), m_state(State::CODE), m_literal(0), m_literal_bits(0)
+                {
+                    rebuild_tree();
+                }
+
+                void push(Datum bit)
+                {
+                    assert(bit == 0 || bit == 1);
+
+                    switch (m_state)
+                    {
+                    case State::CODE:
+                    {
+                        m_current = m_tree.child(m_current, bit);
+
+                        if (data::FlatTree::is_leaf(m_current))
+                        {
+                            auto datum = data::FlatTree::datum(m_current);
+
+                            if (datum == EOF_DATUM)
+                            {
+                                m_state = State::DONE;
+                            }
+                            else if (datum == NYT)
+                            {
+                                m_state = State::LITERAL;
+                                m_literal = 0;
+                                m_literal_bits = 0;
+                            }
+                            else
+                            {
+                                emit(datum);
+                            }
+                        }
+                        break;
+                    }
+
+                    case State::LITERAL:
+                        m_literal = (m_literal << 1) | bit;
+
+                        if (++m_literal_bits == BITS_PER_DATUM)
+                        {
+                            // Literals have room for EOF and NYT too, and a datum is only spelled out once
+                            if (m_literal >= N || m_frequencies[m_literal] != 0)
+                            {
+                                fail();
+                                break;
+                            }
+
+                            m_state = State::CODE;
+                            emit(m_literal);
+                        }
+                        break;
+
+                    case State::DONE:
+                        // Padding after EOF, or anything after a failure
+                        break;
+                    }
+                }
+
+                // Data cut short before EOF are incomplete
+                void finish()
+                {
+                    if (m_state != State::DONE)
+                    {
+                        fail();
+                    }
+
+                    m_next.finish();
+                }
+
+                void fail()
+                {
+                    m_state = State::DONE;
+                    m_next.fail();
+                }
+
+            private:
+                void emit(Datum datum)
+                {
+                    m_next.push(datum);
+                    m_frequencies.increment(datum);
+                    rebuild_tree();
+                }
+
+                void rebuild_tree()
+                {
+                    encoding::huffman::build_flat_tree(m_frequencies, m_tree);
+                    m_current = m_tree.root();
+
+                    assert(!data::FlatTree::is_leaf(m_current));
+                }
+            };
+
+        private:
+            static data::FrequencyTable<Datum> create_initial_frequencies()
+            {
+                data::FrequencyTable<Datum> frequencies;
+
+                frequencies.add_to_domain(EOF_DATUM);
+                frequencies.add_to_domain(NYT);
+
+                return frequencies;
+            }
+        };
+
+        template<u64 N>
+        inline constexpr AdaptiveHuffmanStage<N> adaptive_huffman{};
+    }
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef FUSED_BIT_GROUPER_H
+#define FUSED_BIT_GROUPER_H
+
+#include "encoding/fused/pipeline.h"
+#include "util.h"
+#include <assert.h>
+
+
+namespace encoding
+{
+    namespace fused
+    {
+        // Also behind bit_grouper<GROUP_SIZE>. Bits are grouped most significant first
+        // and the last group is padded with zeros
+        template<unsigned GROUP_SIZE>
+        struct BitGrouperStage : public Fusable
+        {
+            static_assert(0 < GROUP_SIZE && GROUP_SIZE < 64, "Groups must fit in a datum");
+
+            static constexpr u64 input_domain = 2;
+            static constexpr u64 output_domain = u64(1) << GROUP_SIZE;
+
+            static u64 max_encoded_size(u64 input_size)
+            {
+                return (input_size + GROUP_SIZE - 1) / GROUP_SIZE;
+            }
+
+            template<typename NEXT>
+            class Encoder
+            {
+            private:
+                NEXT m_next;
+                Datum m_group;
+                unsigned m_bit_count;
+
+            public:
+                Encoder(NEXT next) : m_next(std::move(next)), m_group(0), m_bit_count(0)
+                {
+                    // NOP
+                }
+
+                void push(Datum bit)
+                {
+                    assert(bit == 0 || bit == 1);
+
+                    m_group = (m_group << 1) | bit;
+
+                    if (++m_bit_count == GROUP_SIZE)
+                    {
+                        m_next.push(m_group);
+                        m_group = 0;
+                        m_bit_count = 0;
+                    }
+                }
+
+                void finish()
+                {
+                    if (m_bit_count != 0)
+                    {
+                        m_next.push(m_group << (GROUP_SIZE - m_bit_count));
+                    }
+
+                    m_next.finish();
+                }
+            };
+
+            template<typename NEXT>
+            class Decoder
+            {
+            private:
+                NEXT m_next;
+
+            public:
+                Decoder(NEXT next) : m_next(std::move(next))
+                {
+                    // NOP
+                }
+
+                void push(Datum group)
+                {
+                    assert(group < output_domain);
+
+                    for (unsigned i = GROUP_SIZE; i-- > 0; )
+                    {
+                        m_next.push((group >> i) & 1);
+                    }
+                }
+
+                void finish()
+                {
+                    m_next.finish();
+                }
+
+                void fail()
+                {
+                    m_next.fail();
+                }
+            };
+        };
+
+        template<unsigned GROUP_SIZE>
+        inline constexpr BitGrouperStage<GROUP_SIZE> bit_grouper{};
+    }
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef FUSED_EOF_H
+#define FUSED_EOF_H
+
+#include "encoding/fused/pipeline.h"
+#include "util.h"
+#include <assert.h>
+
+
+namespace encoding
+{
+    namespace fused
+    {
+        // Appends N to mark the end of the data; also behind eof_encoding<N>
+        template<u64 N>
+        struct EofStage : public Fusable
+        {
+            static constexpr u64 input_domain = N;
+            static constexpr u64 output_domain = N + 1;
+
+            static u64 max_encoded_size(u64 input_size)
+            {
+                return input_size + 1;
+            }
+
+            template<typename NEXT>
+            class Encoder
+            {
+            private:
+                NEXT m_next;
+
+            public:
+                Encoder(NEXT next) : m_next(std::move(next))
+                {
+                    // NOP
+                }
+
+                void push(Datum datum)
+                {
+                    assert(datum < N);
+
+                    m_next.push(datum);
+                }
+
+                void finish()
+                {
+                    m_next.push(N);
+                    m_next.finish();
+                }
+            };
+
+            template<typename NEXT>
+            class Decoder
+            {
+            private:
+                NEXT m_next;
+                bool m_eof_reached;
+
+            public:
+                Decoder(NEXT next) : m_next(std::move(next)), m_eof_reached(false)
+                {
+                    // NOP
+                }
+
+                void push(Datum datum)
+                {
+                    if (m_eof_reached)
+                    {
+                        return;
+                    }
+
+                    if (datum == N)
+                    {
+                        m_eof_reached = true;
+                    }
+                    else
+                    {
+                        m_next.push(datum);
+                    }
+                }
+
+                // Data cut short before EOF are incomplete
+                void finish()
+                {
+                    if (!m_eof_reached)
+                    {
+                        m_next.fail();
+                    }
+
+                    m_next.finish();
+                }
+
+                void fail()
+                {
+                    m_next.fail();
+                }
+            };
+        };
+
+        template<u64 N>
+        inline constexpr EofStage<N> eof{};
+    }
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef FUSED_H
+#define FUSED_H
+
+#include "encoding/fused/pipeline.h"
+#include "encoding/fused/eof.h"
+#include "encoding/fused/move-to-front.h"
+#include "encoding/fused/bit-grouper.h"
+#include "encoding/fused/adaptive-huffman.h"
+#include "encoding/fused/lazy.h"
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef FUSED_LAZY_H
+#define FUSED_LAZY_H
+
+#include "encoding/fused/pipeline.h"
+#include "io/generator.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace encoding
+{
+    // Pull-based execution of fused pipelines: every stage runs in its own coroutine and asks
+    // its upstream stage for the next batch only when its own output has been consumed.
+    // Memory use is bounded by a few batches per stage, whatever the input size, and data
+    // is handed over while still in cache, all on a single thread
+    namespace fused
+    {
+        constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+
+        class BatchSink : public FailureFlag
+        {
+        private:
+            std::vector<Datum>* m_batch;
+
+        public:
+            BatchSink(std::vector<Datum>& batch, bool* failed) : FailureFlag(failed), m_batch(&batch)
+            {
+                // NOP
+            }
+
+            void push(Datum datum)
+            {
+                m_batch->push_back(datum);
+            }
+
+            void finish()
+            {
+                // NOP
+            }
+        };
+
+        // Runs CODER (a stage's Encoder or Decoder) over the upstream batches.
+        // A batch is handed downstream as soon as batch_size data have been produced.
+        // Failures of any stage end up in the one flag, which must outlive the generator
+        template<typename CODER>
+        io::BatchGenerator run_lazily(io::BatchGenerator upstream, size_t batch_size, bool* failed)
+        {
+            assert(batch_size > 0);
+
+            std::vector<Datum> batch;
+            batch.reserve(batch_size);
+            CODER coder{ BatchSink(batch, failed) };
+
+            for (auto input : upstream)
+            {
+                for (auto datum : input)
+                {
+                    coder.push(datum);
+
+                    if (batch.size() >= batch_size)
+                    {
+                        co_yield std::span<const Datum>(batch);
+                        batch.clear();
+                    }
+                }
+            }
+
+            coder.finish();
+
+            if (!batch.empty())
+            {
+                co_yield std::span<const Datum>(batch);
+            }
+        }
+
+        template<typename... STAGES>
+        struct LazyChain;
+
+        template<>
+        struct LazyChain<>
+        {
+            static io::BatchGenerator encode(io::BatchGenerator input, size_t)
+            {
+                return input;
+            }
+
+            static io::BatchGenerator decode(io::BatchGenerator input, size_t, bool*)
+            {
+                return input;
+            }
+        };
+
+        template<typename STAGE, typename... REST>
+        struct LazyChain<STAGE, REST...>
+        {
+            static io::BatchGenerator encode(io::BatchGenerator input, size_t batch_size)
+            {
+                return LazyChain<REST...>::encode(run_lazily<typename STAGE::template Encoder<BatchSink>>(std::move(input), batch_size, nullptr), batch_size);
+            }
+
+            // The last stage's decoder has to run first
+            static io::BatchGenerator decode(io::BatchGenerator input, size_t batch_size, bool* failed)
+            {
+                return run_lazily<typename STAGE::template Decoder<BatchSink>>(LazyChain<REST...>::decode(std::move(input), batch_size, failed), batch_size, failed);
+            }
+        };
+
+        template<typename F, typename PIPELINE = typename AsPipeline<F>::type>
+        io::BatchGenerator encode_lazily(const F&, io::BatchGenerator input, size_t batch_size = DEFAULT_BATCH_SIZE)
+        {
+            return PIPELINE::template apply<LazyChain>::encode(std::move(input), batch_size);
+        }
+
+        // If given, *failed is set once a stage finds the input corrupt
+        template<typename F, typename PIPELINE = typename AsPipeline<F>::type>
+        io::BatchGenerator decode_lazily(const F&, io::BatchGenerator input, size_t batch_size = DEFAULT_BATCH_SIZE, bool* failed = nullptr)
+        {
+            return PIPELINE::template apply<LazyChain>::decode(std::move(input), batch_size, failed);
+        }
+
+        template<typename PIPELINE>
+        class LazyEncodingImplementation : public EncodingImplementation
+        {
+        private:
+            size_t m_batch_size;
+
+        public:
+            LazyEncodingImplementation(size_t batch_size) : m_batch_size(batch_size)
+            {
+                assert(batch_size > 0);
+            }
+
+            void encode(io::InputStream& input, io::OutputStream& output) const override
+            {
+                io::write_batches(encode_lazily(PIPELINE(), io::read_batches(input, m_batch_size), m_batch_size), output);
+            }
+
+            void decode(io::InputStream& input, io::OutputStream& output) const override
+            {
+                bool failed = false;
+
+                io::write_batches(decode_lazily(PIPELINE(), io::read_batches(input, m_batch_size), m_batch_size, &failed), output);
+
+                if (failed)
+                {
+                    input.fail();
+                }
+            }
+
+            u64 max_encoded_size(u64 input_size) const override
+            {
+                return PIPELINE::max_encoded_size(input_size);
+            }
+        };
+
+        // Like to_encoding, but streams through the stages batch by batch
+        template<typename F, typename PIPELINE = typename AsPipeline<F>::type>
+        Encoding<PIPELINE::input_domain, PIPELINE::output_domain> to_lazy_encoding(const F&, size_t batch_size = DEFAULT_BATCH_SIZE)
+        {
+            return Encoding<PIPELINE::input_domain, PIPELINE::output_domain>(std::make_shared<LazyEncodingImplementation<PIPELINE>>(batch_size));
+        }
+    }
+}
+
+#endif
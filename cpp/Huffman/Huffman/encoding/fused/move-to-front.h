@@ -0,0 +1,101 @@
+#ifndef FUSED_MOVE_TO_FRONT_H
+#define FUSED_MOVE_TO_FRONT_H
+
+#include "encoding/fused/pipeline.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+namespace encoding
+{
+    namespace fused
+    {
+        // Also behind move_to_front<N>
+        template<u64 N>
+        struct MoveToFrontStage : public Fusable
+        {
+            static constexpr u64 input_domain = N;
+            static constexpr u64 output_domain = N;
+
+            static u64 max_encoded_size(u64 input_size)
+            {
+                return input_size;
+            }
+
+            template<typename NEXT>
+            class Encoder
+            {
+            private:
+                NEXT m_next;
+                std::vector<Datum> m_table;
+
+            public:
+                Encoder(NEXT next) : m_next(std::move(next)), m_table(N)
+                {
+                    std::iota(m_table.begin(), m_table.end(), Datum(0));
+                }
+
+                void push(Datum datum)
+                {
+                    assert(datum < N);
+
+                    auto it = std::find(m_table.begin(), m_table.end(), datum);
+                    auto index = Datum(it - m_table.begin());
+
+                    std::move_backward(m_table.begin(), it, it + 1);
+                    m_table.front() = datum;
+                    m_next.push(index);
+                }
+
+                void finish()
+                {
+                    m_next.finish();
+                }
+            };
+
+            template<typename NEXT>
+            class Decoder
+            {
+            private:
+                NEXT m_next;
+                std::vector<Datum> m_table;
+
+            public:
+                Decoder(NEXT next) : m_next(std::move(next)), m_table(N)
+                {
+                    std::iota(m_table.begin(), m_table.end(), Datum(0));
+                }
+
+                void push(Datum index)
+                {
+                    assert(index < N);
+
+                    auto it = m_table.begin() + index;
+                    auto datum = *it;
+
+                    std::move_backward(m_table.begin(), it, it + 1);
+                    m_table.front() = datum;
+                    m_next.push(datum);
+                }
+
+                void finish()
+                {
+                    m_next.finish();
+                }
+
+                void fail()
+                {
+                    m_next.fail();
+                }
+            };
+        };
+
+        template<u64 N>
+        inline constexpr MoveToFrontStage<N> move_to_front{};
+    }
+}
+
+#endif
@@ -0,0 +1,328 @@
+#ifndef FUSED_PIPELINE_H
+#define FUSED_PIPELINE_H
+
+#include "encoding/encoding.h"
+#include "io/streams.h"
+#include "util.h"
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace encoding
+{
+    // Pipelines whose composition is known at compile time. Every stage is a type with
+    //
+    //   static constexpr u64 input_domain, output_domain;
+    //   template<typename NEXT> class Encoder;    // push(Datum) and finish(), forwarding to NEXT
+    //   template<typename NEXT> class Decoder;    // idem, in the opposite direction, plus fail()
+    //   static u64 max_encoded_size(u64 input_size);
+    //
+    // Data is pushed through the chain of encoders or decoders, which hold each other by value,
+    // so the compiler sees the whole pipeline at once and no intermediate buffers are needed.
+    // A decoder that finds its input corrupt calls fail(), which is forwarded down to the sink; it may assume
+    // that what it is pushed lies in its output domain, and must itself only push data in its input domain
+    namespace fused
+    {
+        // Marks stages and pipelines, so that operator| only applies to them
+        struct Fusable
+        {
+            // NOP
+        };
+
+        // Sinks record failures in a flag owned by whoever runs the chain; encoders never fail
+        class FailureFlag
+        {
+        private:
+            bool* m_failed;
+
+        public:
+            FailureFlag(bool* failed) : m_failed(failed)
+            {
+                // NOP
+            }
+
+            void fail()
+            {
+                if (m_failed != nullptr)
+                {
+                    *m_failed = true;
+                }
+            }
+        };
+
+        // Writes the pipeline's output to a stream
+        class StreamSink : public FailureFlag
+        {
+        private:
+            io::OutputStream* m_output;
+
+        public:
+            StreamSink(io::OutputStream& output, bool* failed = nullptr) : FailureFlag(failed), m_output(&output)
+            {
+                // NOP
+            }
+
+            void push(Datum datum)
+            {
+                m_output->write(datum);
+            }
+
+            void finish()
+            {
+                // NOP
+            }
+        };
+
+        template<typename T>
+        class VectorSink : public FailureFlag
+        {
+        private:
+            std::vector<T>* m_output;
+
+        public:
+            VectorSink(std::vector<T>& output, bool* failed = nullptr) : FailureFlag(failed), m_output(&output)
+            {
+                // NOP
+            }
+
+            void push(Datum datum)
+            {
+                assert(datum <= std::numeric_limits<T>::max());
+
+                m_output->push_back(static_cast<T>(datum));
+            }
+
+            void finish()
+            {
+                // NOP
+            }
+        };
+
+        template<typename SINK, typename... STAGES>
+        struct EncoderChain;
+
+        template<typename SINK>
+        struct EncoderChain<SINK>
+        {
+            typedef SINK type;
+
+            static type create(SINK sink)
+            {
+                return sink;
+            }
+        };
+
+        template<typename SINK, typename STAGE, typename... REST>
+        struct EncoderChain<SINK, STAGE, REST...>
+        {
+            typedef typename STAGE::template Encoder<typename EncoderChain<SINK, REST...>::type> type;
+
+            static type create(SINK sink)
+            {
+                return type(EncoderChain<SINK, REST...>::create(std::move(sink)));
+            }
+        };
+
+        // Decoding runs through the stages in reverse: the first stage's decoder feeds the sink
+        template<typename SINK, typename... STAGES>
+        struct DecoderChain;
+
+        template<typename SINK>
+        struct DecoderChain<SINK>
+        {
+            typedef SINK type;
+
+            static type create(SINK sink)
+            {
+                return sink;
+            }
+        };
+
+        template<typename SINK, typename STAGE, typename... REST>
+        struct DecoderChain<SINK, STAGE, REST...>
+        {
+            typedef typename STAGE::template Decoder<SINK> first;
+            typedef typename DecoderChain<first, REST...>::type type;
+
+            static type create(SINK sink)
+            {
+                return DecoderChain<first, REST...>::create(first(std::move(sink)));
+            }
+        };
+
+        template<typename... STAGES>
+        class Pipeline : public Fusable
+        {
+            static_assert(sizeof...(STAGES) > 0, "Pipelines need at least one stage");
+
+        private:
+            static constexpr u64 input_domains[] = { STAGES::input_domain... };
+            static constexpr u64 output_domains[] = { STAGES::output_domain... };
+
+            static constexpr bool domains_match()
+            {
+                for (size_t i = 1; i < sizeof...(STAGES); ++i)
+                {
+                    if (input_domains[i] != output_domains[i - 1])
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            static_assert(domains_match(), "Each stage's input domain must equal the previous stage's output domain");
+
+        public:
+            static constexpr u64 input_domain = input_domains[0];
+            static constexpr u64 output_domain = output_domains[sizeof...(STAGES) - 1];
+
+            // Instantiates T with this pipeline's stages
+            template<template<typename...> class T>
+            using apply = T<STAGES...>;
+
+            template<typename SINK>
+            static typename EncoderChain<SINK, STAGES...>::type encoder(SINK sink)
+            {
+                return EncoderChain<SINK, STAGES...>::create(std::move(sink));
+            }
+
+            template<typename SINK>
+            static typename DecoderChain<SINK, STAGES...>::type decoder(SINK sink)
+            {
+                return DecoderChain<SINK, STAGES...>::create(std::move(sink));
+            }
+
+            static u64 max_encoded_size(u64 input_size)
+            {
+                u64 result = input_size;
+
+                ((result = result == UNBOUNDED ? UNBOUNDED : STAGES::max_encoded_size(result)), ...);
+
+                return result;
+            }
+
+            void encode(io::InputStream& input, io::OutputStream& output) const
+            {
+                run(input, encoder(StreamSink(output)));
+            }
+
+            void decode(io::InputStream& input, io::OutputStream& output) const
+            {
+                bool failed = false;
+
+                run(input, decoder(StreamSink(output, &failed)));
+
+                if (failed)
+                {
+                    input.fail();
+                }
+            }
+
+            // Without streams, not a single virtual call remains
+            template<typename T, typename U>
+            void encode(std::span<const T> input, std::vector<U>& output) const
+            {
+                run(input, encoder(VectorSink<U>(output)));
+            }
+
+            // Returns false if the input turned out to be corrupt
+            template<typename T, typename U>
+            bool decode(std::span<const T> input, std::vector<U>& output) const
+            {
+                bool failed = false;
+
+                run(input, decoder(VectorSink<U>(output, &failed)));
+
+                return !failed;
+            }
+
+        private:
+            template<typename CHAIN>
+            static void run(io::InputStream& input, CHAIN chain)
+            {
+                while (!input.end_reached())
+                {
+                    chain.push(input.read());
+                }
+
+                chain.finish();
+            }
+
+            template<typename T, typename CHAIN>
+            static void run(std::span<const T> input, CHAIN chain)
+            {
+                for (auto datum : input)
+                {
+                    chain.push(datum);
+                }
+
+                chain.finish();
+            }
+        };
+
+        template<typename STAGE>
+        struct AsPipeline
+        {
+            typedef Pipeline<STAGE> type;
+        };
+
+        template<typename... STAGES>
+        struct AsPipeline<Pipeline<STAGES...>>
+        {
+            typedef Pipeline<STAGES...> type;
+        };
+
+        template<typename P, typename Q>
+        struct Concatenation;
+
+        template<typename... PS, typename... QS>
+        struct Concatenation<Pipeline<PS...>, Pipeline<QS...>>
+        {
+            typedef Pipeline<PS..., QS...> type;
+        };
+
+        template<typename A, typename B, typename = std::enable_if_t<std::is_base_of_v<Fusable, A> && std::is_base_of_v<Fusable, B>>>
+        constexpr typename Concatenation<typename AsPipeline<A>::type, typename AsPipeline<B>::type>::type operator |(const A&, const B&)
+        {
+            return typename Concatenation<typename AsPipeline<A>::type, typename AsPipeline<B>::type>::type();
+        }
+
+        template<typename PIPELINE>
+        class FusedEncodingImplementation : public EncodingImplementation
+        {
+        private:
+            PIPELINE m_pipeline;
+
+        public:
+            void encode(io::InputStream& input, io::OutputStream& output) const override
+            {
+                m_pipeline.encode(input, output);
+            }
+
+            void decode(io::InputStream& input, io::OutputStream& output) const override
+            {
+                m_pipeline.decode(input, output);
+            }
+
+            u64 max_encoded_size(u64 input_size) const override
+            {
+                return PIPELINE::max_encoded_size(input_size);
+            }
+        };
+
+        // Type-erased wrapper, so that fused pipelines can be combined with all other encodings
+        template<typename F, typename PIPELINE = typename AsPipeline<F>::type>
+        Encoding<PIPELINE::input_domain, PIPELINE::output_domain> to_encoding(const F&)
+        {
+            return Encoding<PIPELINE::input_domain, PIPELINE::output_domain>(std::make_shared<FusedEncodingImplementation<PIPELINE>>());
+        }
+    }
+}
+
+#endif
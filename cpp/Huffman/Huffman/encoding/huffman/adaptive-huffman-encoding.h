@@ -2,20 +2,17 @@
 #define ADAPTIVE_HUFFMAN_ENCODING
 
 #include "encoding/encoding.h"
+#include "encoding/fused/adaptive-huffman.h"
 #include "util.h"
-#include <memory>
 
 
 namespace encoding
 {
-    std::shared_ptr<EncodingImplementation> create_adaptive_huffman_implementation(u64 domain_size);
-
     template<u64 IN>
     Encoding<IN, 2> adaptive_huffman()
     {
-        return encoding::Encoding<IN, 2>(create_adaptive_huffman_implementation(IN));
+        return fused::to_encoding(fused::adaptive_huffman<IN>);
     }
 }
 
 #endif
-
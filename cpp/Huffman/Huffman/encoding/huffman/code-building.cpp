@@ -1,4 +1,5 @@
 #include "encoding/huffman/code-building.h"
+#include <algorithm>
 
 
 namespace
@@ -36,3 +37,70 @@ std::vector<std::vector<Datum>> encoding::huffman::build_codes(const data::Node<
     ::build_codes(tree, prefix, &result);
     return result;
 }
+
+std::vector<std::vector<Datum>> encoding::huffman::build_codes(const data::FlatTree& tree, u64 domain_size)
+{
+    struct Entry
+    {
+        data::FlatTree::node node;
+        size_t depth;
+        Datum bit;
+    };
+
+    std::vector<std::vector<Datum>> result(domain_size);
+    std::vector<Datum> prefix;
+    std::vector<Entry> stack{ Entry{ tree.root(), 0, 0 } };
+
+    // Preorder, so that when a node is popped, the prefix still starts with the code of its parent
+    while (!stack.empty())
+    {
+        auto entry = stack.back();
+        stack.pop_back();
+
+        if (entry.depth > 0)
+        {
+            prefix.resize(entry.depth - 1);
+            prefix.push_back(entry.bit);
+        }
+
+        if (data::FlatTree::is_leaf(entry.node))
+        {
+            auto datum = data::FlatTree::datum(entry.node);
+
+            assert(datum < result.size());
+
+            result[datum] = prefix;
+        }
+        else
+        {
+            stack.push_back(Entry{ tree.child(entry.node, 1), entry.depth + 1, 1 });
+            stack.push_back(Entry{ tree.child(entry.node, 0), entry.depth + 1, 0 });
+        }
+    }
+
+    return result;
+}
+
+bool encoding::huffman::find_code(const data::FlatTree& tree, Datum datum, std::vector<Datum>& code)
+{
+    auto target = data::FlatTree::leaf(datum);
+
+    code.clear();
+
+    // Children are added before their parents, so the path up to the root is found in a single pass over the branches
+    for (size_t branch = 0; branch != tree.branch_count() && target != tree.root(); ++branch)
+    {
+        for (Datum bit = 0; bit != 2; ++bit)
+        {
+            if (tree.child(data::FlatTree::node(branch), bit) == target)
+            {
+                code.push_back(bit);
+                target = data::FlatTree::node(branch);
+            }
+        }
+    }
+
+    std::reverse(code.begin(), code.end());
+
+    return target == tree.root();
+}
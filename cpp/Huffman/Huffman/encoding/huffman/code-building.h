@@ -2,6 +2,7 @@
 #define CODE_BUILDING_H
 
 #include "data/binary-tree.h"
+#include "data/flat-tree.h"
 #include <vector>
 #include "util.h"
 
@@ -10,6 +11,10 @@ namespace encoding
     namespace huffman
     {
         std::vector<std::vector<Datum>> build_codes(const data::Node<Datum>& tree, u64 domain_size);
+        std::vector<std::vector<Datum>> build_codes(const data::FlatTree& tree, u64 domain_size);
+
+        // Code of a single datum, overwriting code without releasing its capacity. Returns false if datum is not in the tree
+        bool find_code(const data::FlatTree& tree, Datum datum, std::vector<Datum>& code);
     }
 }
 
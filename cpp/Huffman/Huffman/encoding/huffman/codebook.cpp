@@ -0,0 +1,63 @@
+#include "encoding/huffman/codebook.h"
+#include "encoding/huffman/tree-building.h"
+#include "encoding/huffman/code-building.h"
+#include "data/frequency-table.h"
+#include <assert.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+
+namespace
+{
+    std::mutex registry_mutex;
+
+    std::map<u64, std::shared_ptr<const encoding::huffman::Codebook>>& registry()
+    {
+        static std::map<u64, std::shared_ptr<const encoding::huffman::Codebook>> codebooks;
+
+        return codebooks;
+    }
+}
+
+encoding::huffman::Codebook::Codebook(std::unique_ptr<data::Node<Datum>> tree, u64 domain_size)
+    : m_domain_size(domain_size), m_tree(std::move(tree)), m_flat_tree(*m_tree), m_codes(build_codes(*m_tree, domain_size)), m_max_code_length(0)
+{
+    assert(m_tree->is_branch());
+
+    for (auto& code : m_codes)
+    {
+        m_max_code_length = std::max<u64>(m_max_code_length, code.size());
+    }
+}
+
+std::shared_ptr<const encoding::huffman::Codebook> encoding::huffman::train_codebook(const std::vector<Datum>& corpus, u64 domain_size)
+{
+    assert(domain_size >= 2);
+
+    auto frequencies = data::count_frequencies(corpus);
+
+    for (Datum datum = 0; datum != domain_size; ++datum)
+    {
+        frequencies.add_to_domain(datum);
+    }
+
+    return std::make_shared<Codebook>(build_tree(frequencies), domain_size);
+}
+
+bool encoding::huffman::register_codebook(u64 id, std::shared_ptr<const Codebook> codebook)
+{
+    assert(codebook != nullptr);
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    return registry().emplace(id, codebook).second;
+}
+
+std::shared_ptr<const encoding::huffman::Codebook> encoding::huffman::find_codebook(u64 id)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry().find(id);
+
+    return it != registry().end() ? it->second : nullptr;
+}
@@ -0,0 +1,72 @@
+#ifndef CODEBOOK_H
+#define CODEBOOK_H
+
+#include "data/binary-tree.h"
+#include "data/flat-tree.h"
+#include "util.h"
+#include <memory>
+#include <vector>
+
+
+namespace encoding
+{
+    namespace huffman
+    {
+        // Huffman tree together with the codes derived from it, built once and shared by all messages
+        class Codebook
+        {
+        private:
+            u64 m_domain_size;
+            std::unique_ptr<data::Node<Datum>> m_tree;
+            data::FlatTree m_flat_tree;
+            std::vector<std::vector<Datum>> m_codes;
+            u64 m_max_code_length;
+
+        public:
+            // tree must contain every datum in [0, domain_size) so that any message can be encoded
+            Codebook(std::unique_ptr<data::Node<Datum>> tree, u64 domain_size);
+
+            u64 domain_size() const
+            {
+                return m_domain_size;
+            }
+
+            const data::Node<Datum>& tree() const
+            {
+                return *m_tree;
+            }
+
+            // Same tree, faster to walk when decoding
+            const data::FlatTree& flat_tree() const
+            {
+                return m_flat_tree;
+            }
+
+            u64 max_code_length() const
+            {
+                return m_max_code_length;
+            }
+
+            const std::vector<Datum>& code(Datum datum) const
+            {
+                assert(datum < m_domain_size);
+
+                return m_codes[datum];
+            }
+        };
+
+        // Builds a codebook from the frequencies in corpus. Data missing from the corpus
+        // are still given a (long) code
+        std::shared_ptr<const Codebook> train_codebook(const std::vector<Datum>& corpus, u64 domain_size);
+
+        // Process-wide table of codebooks, identified by the ID written in the header of static Huffman encodings.
+        // Codebooks are meant to be registered once at startup. Returns false, leaving the registry unchanged,
+        // if the ID is already taken
+        bool register_codebook(u64 id, std::shared_ptr<const Codebook> codebook);
+
+        // Returns nullptr for unknown IDs
+        std::shared_ptr<const Codebook> find_codebook(u64 id);
+    }
+}
+
+#endif
@@ -42,3 +42,47 @@ Datum encoding::huffman::decode_single_datum(io::InputStream& input, const data:
 
     return 0;
 }
+
+void encoding::huffman::decode_bits(io::InputStream& input, const data::FlatTree& tree, io::OutputStream& output)
+{
+    // A tree that is a single leaf has no codes, so there is nothing to decode
+    if (data::FlatTree::is_leaf(tree.root()))
+    {
+        return;
+    }
+
+    while (!input.end_reached())
+    {
+        auto current_node = tree.root();
+
+        while (!data::FlatTree::is_leaf(current_node) && !input.end_reached())
+        {
+            current_node = tree.child(current_node, input.read());
+        }
+
+        // An incomplete code at the end is padding
+        if (data::FlatTree::is_leaf(current_node))
+        {
+            output.write(data::FlatTree::datum(current_node));
+        }
+    }
+}
+
+Datum encoding::huffman::decode_single_datum(io::InputStream& input, const data::FlatTree& tree)
+{
+    auto current_node = tree.root();
+
+    while (!input.end_reached())
+    {
+        assert(!data::FlatTree::is_leaf(current_node));
+
+        current_node = tree.child(current_node, input.read());
+
+        if (data::FlatTree::is_leaf(current_node))
+        {
+            return data::FlatTree::datum(current_node);
+        }
+    }
+
+    return 0;
+}
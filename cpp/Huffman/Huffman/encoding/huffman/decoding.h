@@ -3,6 +3,7 @@
 
 #include "io/streams.h"
 #include "data/binary-tree.h"
+#include "data/flat-tree.h"
 #include "util.h"
 
 
@@ -13,6 +14,10 @@ namespace encoding
         void decode_bits(io::InputStream& input, const data::Node<Datum>& tree, io::OutputStream& output);
 
         Datum decode_single_datum(io::InputStream& input, const data::Node<Datum>& tree);
+
+        void decode_bits(io::InputStream& input, const data::FlatTree& tree, io::OutputStream& output);
+
+        Datum decode_single_datum(io::InputStream& input, const data::FlatTree& tree);
     }
 }
 
@@ -5,11 +5,13 @@
 #include "encoding/huffman/decoding.h"
 #include "data/frequency-table.h"
 #include "data/binary-tree.h"
+#include "data/flat-tree.h"
 #include "io/memory-buffer.h"
 #include "io/streams.h"
 #include "io/io-util.h"
 #include "util.h"
 #include <assert.h>
+#include <algorithm>
 #include <utility>
 #include <memory>
 
@@ -28,39 +30,70 @@ namespace
 
         void encode(io::InputStream& input, io::OutputStream& output) const override
         {
-            auto copy = copy_to_vector(input);
-            auto frequencies = data::count_frequencies(copy);
-            auto tree = encoding::huffman::build_tree(frequencies);
-            auto codes = encoding::huffman::build_codes(*tree, m_domain_size + 1);
+            if (input.rewindable())
+            {
+                encode_in_two_passes(input, output);
+                return;
+            }
 
-            encoding::huffman::encode_tree(*tree, m_bits_per_datum, output);
-            this->encode_input(copy, codes, output);
+            // The input has to be kept around until the tree is known; store it compactly
+            with_integer_type_for_domain_size(m_domain_size, [&](auto type) {
+                auto copy = io::read_all<decltype(type)>(input);
+                auto frequencies = data::count_frequencies_as<Datum>(copy);
+                auto tree = encoding::huffman::build_flat_tree(frequencies);
+                auto codes = encoding::huffman::build_codes(tree, m_domain_size + 1);
+
+                encoding::huffman::encode_tree(tree, m_bits_per_datum, output);
+                this->encode_input(copy, codes, output);
+            });
         }
 
         void decode(io::InputStream& input, io::OutputStream& output) const override
         {
-            auto tree = encoding::huffman::decode_tree(m_bits_per_datum, input);
-            encoding::huffman::decode_bits(input, *tree, output);
+            auto tree = encoding::huffman::decode_flat_tree(m_bits_per_datum, m_domain_size, input);
+            encoding::huffman::decode_bits(input, tree, output);
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            auto leaf_count = std::max<u64>(1, std::min(input_size, m_domain_size));
+            auto tree_size = (leaf_count - 1) + leaf_count * (1 + m_bits_per_datum);
+
+            return tree_size + input_size * encoding::huffman::max_code_length(leaf_count, input_size);
         }
 
     private:
-        std::vector<Datum> copy_to_vector(io::InputStream& input) const
+        // First pass counts frequencies, second pass encodes: memory use only depends on the domain size
+        void encode_in_two_passes(io::InputStream& input, io::OutputStream& output) const
         {
-            std::vector<Datum> result;
+            data::FrequencyTable<Datum> frequencies;
+
+            // The input need not be at its start, e.g. when a previous stage has already consumed a header
+            input.mark();
 
             while (!input.end_reached())
             {
-                result.push_back(input.read());
+                frequencies.increment(input.read());
             }
 
-            return result;
+            auto tree = encoding::huffman::build_flat_tree(frequencies);
+            auto codes = encoding::huffman::build_codes(tree, m_domain_size + 1);
+
+            encoding::huffman::encode_tree(tree, m_bits_per_datum, output);
+            input.rewind();
+
+            while (!input.end_reached())
+            {
+                io::transfer(codes[input.read()], output);
+            }
         }
-        
-        void encode_input(const std::vector<Datum>& input, std::vector<std::vector<Datum>>& codes, io::OutputStream& output) const
+
+        template<typename T>
+        void encode_input(const std::vector<T>& input, const std::vector<std::vector<Datum>>& codes, io::OutputStream& output) const
         {
             for ( auto& datum : input )
             {
-                auto code = codes[datum];
+                auto& code = codes[datum];
                 io::transfer(code, output);
             }
         }
@@ -0,0 +1,64 @@
+#include "encoding/huffman/static-huffman-encoding.h"
+#include "encoding/huffman/codebook.h"
+#include "encoding/huffman/decoding.h"
+#include "io/binary-io.h"
+#include "io/io-util.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <memory>
+
+
+namespace
+{
+    class StaticHuffmanEncodingImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        u64 m_domain_size;
+        u64 m_codebook_id;
+        std::shared_ptr<const encoding::huffman::Codebook> m_codebook;
+
+    public:
+        StaticHuffmanEncodingImplementation(u64 domain_size, u64 codebook_id)
+            : m_domain_size(domain_size), m_codebook_id(codebook_id), m_codebook(encoding::huffman::find_codebook(codebook_id))
+        {
+            assert((codebook_id >> encoding::CODEBOOK_ID_BITS) == 0);
+            assert(m_codebook != nullptr);
+            assert(m_codebook->domain_size() == domain_size);
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            io::write_bits(m_codebook_id, encoding::CODEBOOK_ID_BITS, output);
+
+            while (!input.end_reached())
+            {
+                io::transfer(m_codebook->code(input.read()), output);
+            }
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            auto codebook_id = io::read_bits(encoding::CODEBOOK_ID_BITS, input);
+            auto codebook = codebook_id == m_codebook_id ? m_codebook : encoding::huffman::find_codebook(codebook_id);
+
+            if (codebook == nullptr || codebook->domain_size() != m_domain_size)
+            {
+                input.fail();
+                return;
+            }
+
+            encoding::huffman::decode_bits(input, codebook->flat_tree(), output);
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            return encoding::CODEBOOK_ID_BITS + input_size * m_codebook->max_code_length();
+        }
+    };
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_static_huffman_implementation(u64 domain_size, u64 codebook_id)
+{
+    return std::make_shared<StaticHuffmanEncodingImplementation>(domain_size, codebook_id);
+}
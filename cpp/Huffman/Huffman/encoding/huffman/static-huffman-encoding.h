@@ -0,0 +1,26 @@
+#ifndef STATIC_HUFFMAN_ENCODING_H
+#define STATIC_HUFFMAN_ENCODING_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <memory>
+
+
+namespace encoding
+{
+    // Number of bits used to store the codebook ID in the header
+    constexpr unsigned CODEBOOK_ID_BITS = 16;
+
+    std::shared_ptr<EncodingImplementation> create_static_huffman_implementation(u64 domain_size, u64 codebook_id);
+
+    // Huffman encoding with a pre-shared codebook (see encoding/huffman/codebook.h). Only the codebook ID
+    // is written instead of the tree, and no tree is built or parsed per message.
+    // Decoding uses whichever registered codebook the header refers to
+    template<u64 IN>
+    Encoding<IN, 2> static_huffman_encoding(u64 codebook_id)
+    {
+        return encoding::Encoding<IN, 2>(create_static_huffman_implementation(IN, codebook_id));
+    }
+}
+
+#endif
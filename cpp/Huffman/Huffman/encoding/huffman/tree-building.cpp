@@ -1,74 +1,101 @@
 #include "encoding/huffman/tree-building.h"
+#include "io/scratch-buffer.h"
+#include <assert.h>
 #include <algorithm>
+#include <vector>
 
 
 namespace
 {
-    typedef std::pair<Datum, u64> wpair;
-    typedef data::Node<wpair>     wnode;
-    typedef data::Leaf<wpair>     wleaf;
-    typedef data::Branch<wpair>   wbranch;
+    // Weights are kept next to the nodes so that sorting does not need to walk the trees
+    template<typename NODE>
+    struct WeightedNode
+    {
+        NODE node;
+        u64 weight;
+    };
 
-    std::vector<std::unique_ptr<wnode>> create_nodes(const data::FrequencyTable<Datum>& frequencies)
+    template<typename NODE, typename CREATE_LEAF, typename CREATE_BRANCH>
+    NODE build(const data::FrequencyTable<Datum>& frequencies, CREATE_LEAF create_leaf, CREATE_BRANCH create_branch)
     {
-        std::vector<std::unique_ptr<wnode>> result;
+        io::ScratchBuffer<WeightedNode<NODE>> buffer;
+        auto& queue = *buffer;
 
         for (auto& datum : frequencies.values())
         {
-            auto frequency = frequencies[datum];
-            wpair pair(datum, frequency);
-            std::unique_ptr<wnode> node = std::make_unique<wleaf>(pair);
-            result.push_back(std::move(node));
+            queue.push_back(WeightedNode<NODE>{ create_leaf(datum), frequencies[datum] });
         }
 
-        return result;
-    }
+        assert(queue.size() > 0);
 
-    u64 weight(const wnode& node)
-    {
-        if (node.is_leaf())
+        while (queue.size() > 1)
         {
-            const wleaf& leaf = static_cast<const wleaf&>(node);
-            return leaf.value().second;
-        }
-        else
-        {
-            const wbranch& branch = static_cast<const wbranch&>(node);
-            return weight(branch.left_child()) + weight(branch.right_child());
+            std::sort(queue.begin(), queue.end(), [](const WeightedNode<NODE>& p, const WeightedNode<NODE>& q) {
+                return p.weight > q.weight; // sort from heavy to light!
+            });
+
+            assert(queue[0].weight >= queue[1].weight);
+
+            auto left_node = std::move(queue.back());
+            queue.pop_back();
+            auto right_node = std::move(queue.back());
+            queue.pop_back();
+
+            auto weight = left_node.weight + right_node.weight;
+            queue.push_back(WeightedNode<NODE>{ create_branch(std::move(left_node.node), std::move(right_node.node)), weight });
         }
-    }
-    
-    void sort_queue(std::vector<std::unique_ptr<wnode>>& nodes)
-    {
-        std::sort(nodes.begin(), nodes.end(), [](const std::unique_ptr<wnode>& p, const std::unique_ptr<wnode>& q) {
-            return weight(*p) > weight(*q); // sort from heavy to light!
-        });
+
+        assert(queue.size() == 1);
+
+        return std::move(queue.back().node);
     }
 }
 
 std::unique_ptr<data::Node<Datum>> encoding::huffman::build_tree(const data::FrequencyTable<Datum>& frequencies)
 {
-    auto queue = create_nodes(frequencies);
-    assert(queue.size() > 0);
+    typedef std::unique_ptr<data::Node<Datum>> node;
 
-    while (queue.size() > 1)
-    {
-        sort_queue(queue);
+    return build<node>(frequencies,
+        [](Datum datum) -> node { return std::make_unique<data::Leaf<Datum>>(datum); },
+        [](node left, node right) -> node { return std::make_unique<data::Branch<Datum>>(std::move(left), std::move(right)); });
+}
 
-        assert(weight(*queue[0]) >= weight(*queue[1]));
+data::FlatTree encoding::huffman::build_flat_tree(const data::FrequencyTable<Datum>& frequencies)
+{
+    data::FlatTree result;
 
-        auto left_node = std::move(queue.back());
-        queue.pop_back();
-        auto right_node = std::move(queue.back());
-        queue.pop_back();
+    build_flat_tree(frequencies, result);
 
-        auto branch = std::make_unique<wbranch>(std::move(left_node), std::move(right_node));
+    return result;
+}
 
-        queue.push_back(std::move(branch));
-    }
+void encoding::huffman::build_flat_tree(const data::FrequencyTable<Datum>& frequencies, data::FlatTree& result)
+{
+    typedef data::FlatTree::node node;
+
+    result.clear();
+
+    auto root = build<node>(frequencies,
+        [](Datum datum) -> node { return data::FlatTree::leaf(datum); },
+        [&](node left, node right) -> node { return result.branch(left, right); });
+
+    result.set_root(root);
+}
+
+u64 encoding::huffman::max_code_length(u64 leaf_count, u64 total_weight)
+{
+    u64 depth = 0;
+    u64 fibonacci = 1;
+    u64 next_fibonacci = 2;
 
-    assert(queue.size() == 1);
-    auto tree = std::move(queue.back());
+    while (depth + 1 < leaf_count && next_fibonacci <= total_weight)
+    {
+        ++depth;
 
-    return data::map<wpair, Datum>(*tree, [](const wpair& pair) -> Datum { return pair.first; });
-}
\ No newline at end of file
+        auto sum = fibonacci + next_fibonacci;
+        fibonacci = next_fibonacci;
+        next_fibonacci = sum;
+    }
+
+    return depth;
+}
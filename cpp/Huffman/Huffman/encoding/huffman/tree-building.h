@@ -3,6 +3,7 @@
 
 #include "data/frequency-table.h"
 #include "data/binary-tree.h"
+#include "data/flat-tree.h"
 #include <memory>
 
 namespace encoding
@@ -10,6 +11,16 @@ namespace encoding
     namespace huffman
     {
         std::unique_ptr<data::Node<Datum>> build_tree(const data::FrequencyTable<Datum>& frequencies);
+
+        // Builds the same tree in flat form
+        data::FlatTree build_flat_tree(const data::FrequencyTable<Datum>& frequencies);
+
+        // Overwrites result, reusing its capacity, so that rebuilding a tree for every datum does not allocate
+        void build_flat_tree(const data::FrequencyTable<Datum>& frequencies, data::FlatTree& result);
+
+        // Upper bound on the depth of a leaf in a tree built from leaf_count nonzero frequencies adding up to total_weight.
+        // A leaf at depth d requires a total weight of at least the (d+2)th Fibonacci number
+        u64 max_code_length(u64 leaf_count, u64 total_weight);
     }
 }
 
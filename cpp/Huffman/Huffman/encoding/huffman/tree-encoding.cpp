@@ -2,6 +2,8 @@
 #include "encoding/encoding.h"
 #include "io/binary-io.h"
 #include "util.h"
+#include <utility>
+#include <vector>
 
 
 void encoding::huffman::encode_tree(const data::Node<Datum>& tree, unsigned bits_per_datum, io::OutputStream& output)
@@ -22,9 +24,10 @@ void encoding::huffman::encode_tree(const data::Node<Datum>& tree, unsigned bits
     }
 }
 
+// Truncated input ends in leaves, so that corrupt data cannot make decoding go on forever
 std::unique_ptr<data::Node<Datum>> encoding::huffman::decode_tree(unsigned bits_per_datum, io::InputStream& input)
 {
-    if (input.read() == 0)
+    if (!input.end_reached() && input.read() == 0)
     {
         auto left_child = decode_tree(bits_per_datum, input);
         auto right_child = decode_tree(bits_per_datum, input);
@@ -38,3 +41,89 @@ std::unique_ptr<data::Node<Datum>> encoding::huffman::decode_tree(unsigned bits_
         return std::make_unique<data::Leaf<Datum>>(datum);
     }
 }
+
+void encoding::huffman::encode_tree(const data::FlatTree& tree, unsigned bits_per_datum, io::OutputStream& output)
+{
+    // Preorder: the left child is on top of the stack, so it is written before the right one
+    std::vector<data::FlatTree::node> stack{ tree.root() };
+
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+
+        if (data::FlatTree::is_leaf(node))
+        {
+            output.write(1);
+            io::write_bits(data::FlatTree::datum(node), bits_per_datum, output);
+        }
+        else
+        {
+            output.write(0);
+            stack.push_back(tree.child(node, 1));
+            stack.push_back(tree.child(node, 0));
+        }
+    }
+}
+
+// Iterative, so that untrusted input cannot exhaust the stack. A tree over domain_size leaves has at most
+// domain_size - 1 branches, which also bounds its depth; anything else fails the input and decodes
+// as a single leaf, from which no data can be decoded
+data::FlatTree encoding::huffman::decode_flat_tree(unsigned bits_per_datum, u64 domain_size, io::InputStream& input)
+{
+    typedef data::FlatTree::node node;
+
+    data::FlatTree result;
+
+    // Branches whose left child is still being read, or which are waiting for their right child
+    std::vector<std::pair<node, bool>> open;
+    u64 branch_count = 0;
+
+    while (!input.end_reached())
+    {
+        node completed;
+
+        if (input.read() == 0)
+        {
+            if (++branch_count >= domain_size)
+            {
+                break;
+            }
+
+            open.emplace_back(0, false);
+            continue;
+        }
+        else
+        {
+            auto datum = io::read_bits(bits_per_datum, input);
+
+            if (datum >= domain_size || input.failed())
+            {
+                break;
+            }
+
+            completed = data::FlatTree::leaf(datum);
+        }
+
+        while (!open.empty() && open.back().second)
+        {
+            completed = result.branch(open.back().first, completed);
+            open.pop_back();
+        }
+
+        if (open.empty())
+        {
+            result.set_root(completed);
+
+            return result;
+        }
+
+        open.back() = std::make_pair(completed, true);
+    }
+
+    input.fail();
+    result.clear();
+    result.set_root(data::FlatTree::leaf(0));
+
+    return result;
+}
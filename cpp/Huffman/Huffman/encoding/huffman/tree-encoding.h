@@ -3,6 +3,7 @@
 
 #include "io/streams.h"
 #include "data/binary-tree.h"
+#include "data/flat-tree.h"
 #include <memory>
 
 
@@ -12,6 +13,10 @@ namespace encoding
     {
         void encode_tree(const data::Node<Datum>& tree, unsigned bits_per_datum, io::OutputStream& output);
         std::unique_ptr<data::Node<Datum>> decode_tree(unsigned bits_per_datum, io::InputStream& input);
+
+        // Same format as for pointer based trees. Decoding checks the tree against the domain
+        void encode_tree(const data::FlatTree& tree, unsigned bits_per_datum, io::OutputStream& output);
+        data::FlatTree decode_flat_tree(unsigned bits_per_datum, u64 domain_size, io::InputStream& input);
     }
 }
 
@@ -0,0 +1,363 @@
+#include "encoding/instrumentation.h"
+#include "io/streams.h"
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+
+namespace
+{
+    using namespace encoding::instrumentation;
+
+    std::atomic<AllocationProbe> allocation_probe(nullptr);
+
+    AllocationCounts current_allocations()
+    {
+        auto probe = allocation_probe.load(std::memory_order_relaxed);
+
+        return probe != nullptr ? probe() : AllocationCounts{ 0, 0 };
+    }
+
+    double thread_cpu_seconds()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+
+        auto to_ticks = [](const FILETIME& time) { return (u64(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+
+        return double(to_ticks(kernel) + to_ticks(user)) * 1e-7;
+#else
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+        return double(time.tv_sec) + double(time.tv_nsec) * 1e-9;
+#endif
+    }
+
+    // Two pass encodings rewind their input, so the furthest position reached is counted rather than the number of reads
+    class CountingInputStream : public io::InputStream
+    {
+    private:
+        io::InputStream& m_input;
+        u64 m_position;
+        u64 m_mark;
+        u64 m_furthest;
+
+    public:
+        CountingInputStream(io::InputStream& input) : m_input(input), m_position(0), m_mark(0), m_furthest(0)
+        {
+            // NOP
+        }
+
+        Datum read() override
+        {
+            if (++m_position > m_furthest)
+            {
+                m_furthest = m_position;
+            }
+
+            return m_input.read();
+        }
+
+        bool end_reached() const override
+        {
+            return m_input.end_reached();
+        }
+
+        bool rewindable() const override
+        {
+            return m_input.rewindable();
+        }
+
+        void mark() override
+        {
+            m_input.mark();
+            m_mark = m_position;
+        }
+
+        void rewind() override
+        {
+            m_input.rewind();
+            m_position = m_mark;
+        }
+
+        void fail() override
+        {
+            m_input.fail();
+        }
+
+        bool failed() const override
+        {
+            return m_input.failed();
+        }
+
+        u64 count() const
+        {
+            return m_furthest;
+        }
+    };
+
+    class CountingOutputStream : public io::OutputStream
+    {
+    private:
+        io::OutputStream& m_output;
+        u64 m_count;
+
+    public:
+        CountingOutputStream(io::OutputStream& output) : m_output(output), m_count(0)
+        {
+            // NOP
+        }
+
+        void write(Datum value) override
+        {
+            ++m_count;
+            m_output.write(value);
+        }
+
+        bool overflowed() const override
+        {
+            return m_output.overflowed();
+        }
+
+        u64 count() const
+        {
+            return m_count;
+        }
+    };
+
+    class InstrumentedImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        std::shared_ptr<encoding::EncodingImplementation> m_implementation;
+        std::string m_stage;
+        std::shared_ptr<Recorder> m_recorder;
+
+    public:
+        InstrumentedImplementation(std::shared_ptr<encoding::EncodingImplementation> implementation, const std::string& stage, std::shared_ptr<Recorder> recorder)
+            : m_implementation(implementation), m_stage(stage), m_recorder(recorder)
+        {
+            assert(implementation != nullptr);
+            assert(recorder != nullptr);
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            if (m_recorder->enabled())
+            {
+                measure(Operation::ENCODE, input, output);
+            }
+            else
+            {
+                m_implementation->encode(input, output);
+            }
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            if (m_recorder->enabled())
+            {
+                measure(Operation::DECODE, input, output);
+            }
+            else
+            {
+                m_implementation->decode(input, output);
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            return m_implementation->max_encoded_size(input_size);
+        }
+
+    private:
+        void measure(Operation operation, io::InputStream& input, io::OutputStream& output) const
+        {
+            CountingInputStream counting_input(input);
+            CountingOutputStream counting_output(output);
+
+            auto allocations_before = current_allocations();
+            auto cpu_before = thread_cpu_seconds();
+            auto wall_before = std::chrono::steady_clock::now();
+
+            if (operation == Operation::ENCODE)
+            {
+                m_implementation->encode(counting_input, counting_output);
+            }
+            else
+            {
+                m_implementation->decode(counting_input, counting_output);
+            }
+
+            auto wall_after = std::chrono::steady_clock::now();
+            auto cpu_after = thread_cpu_seconds();
+            auto allocations_after = current_allocations();
+
+            StageStatistics statistics;
+            statistics.calls = 1;
+            statistics.symbols_in = counting_input.count();
+            statistics.symbols_out = counting_output.count();
+            statistics.wall_seconds = std::chrono::duration<double>(wall_after - wall_before).count();
+            statistics.cpu_seconds = cpu_after - cpu_before;
+            statistics.peak_output = counting_output.count();
+            statistics.allocations = allocations_after.count - allocations_before.count;
+            statistics.allocated_bytes = allocations_after.bytes - allocations_before.bytes;
+
+            m_recorder->record(m_stage, operation, statistics);
+        }
+    };
+
+    void append_json_string(std::ostringstream& out, const std::string& string)
+    {
+        out << '"';
+
+        for (auto c : string)
+        {
+            switch (c)
+            {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+                    out << escaped;
+                }
+                else
+                {
+                    out << c;
+                }
+            }
+        }
+
+        out << '"';
+    }
+}
+
+void encoding::instrumentation::set_allocation_probe(AllocationProbe probe)
+{
+    allocation_probe.store(probe, std::memory_order_relaxed);
+}
+
+encoding::instrumentation::Recorder::Recorder() : Recorder(nullptr)
+{
+    // NOP
+}
+
+encoding::instrumentation::Recorder::Recorder(std::function<void(const StageReport&)> callback) : m_enabled(true), m_callback(callback)
+{
+    // NOP
+}
+
+void encoding::instrumentation::Recorder::enable()
+{
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void encoding::instrumentation::Recorder::disable()
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+void encoding::instrumentation::Recorder::record(const std::string& stage, Operation operation, const StageStatistics& statistics)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find_if(m_reports.begin(), m_reports.end(), [&](const StageReport& report) {
+            return report.stage == stage && report.operation == operation;
+        });
+
+        if (it == m_reports.end())
+        {
+            m_reports.push_back(StageReport{ stage, operation, statistics });
+        }
+        else
+        {
+            auto& total = it->statistics;
+
+            total.calls += statistics.calls;
+            total.symbols_in += statistics.symbols_in;
+            total.symbols_out += statistics.symbols_out;
+            total.wall_seconds += statistics.wall_seconds;
+            total.cpu_seconds += statistics.cpu_seconds;
+            total.peak_output = std::max(total.peak_output, statistics.peak_output);
+            total.allocations += statistics.allocations;
+            total.allocated_bytes += statistics.allocated_bytes;
+        }
+    }
+
+    if (m_callback)
+    {
+        m_callback(StageReport{ stage, operation, statistics });
+    }
+}
+
+std::vector<encoding::instrumentation::StageReport> encoding::instrumentation::Recorder::report() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_reports;
+}
+
+void encoding::instrumentation::Recorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_reports.clear();
+}
+
+std::string encoding::instrumentation::to_json(const std::vector<StageReport>& reports)
+{
+    std::ostringstream out;
+    out.precision(9);
+
+    out << "{\"stages\":[";
+
+    for (size_t i = 0; i != reports.size(); ++i)
+    {
+        auto& report = reports[i];
+        auto& statistics = report.statistics;
+
+        if (i != 0)
+        {
+            out << ',';
+        }
+
+        out << "{\"stage\":";
+        append_json_string(out, report.stage);
+        out << ",\"operation\":\"" << (report.operation == Operation::ENCODE ? "encode" : "decode") << '"';
+        out << ",\"calls\":" << statistics.calls;
+        out << ",\"symbols_in\":" << statistics.symbols_in;
+        out << ",\"symbols_out\":" << statistics.symbols_out;
+        out << ",\"wall_seconds\":" << statistics.wall_seconds;
+        out << ",\"cpu_seconds\":" << statistics.cpu_seconds;
+        out << ",\"peak_output\":" << statistics.peak_output;
+        out << ",\"allocations\":" << statistics.allocations;
+        out << ",\"allocated_bytes\":" << statistics.allocated_bytes;
+        out << '}';
+    }
+
+    out << "]}";
+
+    return out.str();
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::instrumentation::create_instrumented_implementation(std::shared_ptr<EncodingImplementation> implementation, const std::string& stage, std::shared_ptr<Recorder> recorder)
+{
+    return std::make_shared<InstrumentedImplementation>(implementation, stage, recorder);
+}
@@ -0,0 +1,102 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace encoding
+{
+    namespace instrumentation
+    {
+        enum class Operation { ENCODE, DECODE };
+
+        struct StageStatistics
+        {
+            u64 calls;
+            u64 symbols_in;
+            u64 symbols_out;
+            double wall_seconds;
+            double cpu_seconds;
+
+            // Largest output of a single call. Within a combined encoding, this is
+            // the size of the intermediate buffer the next stage reads from
+            u64 peak_output;
+
+            u64 allocations;
+            u64 allocated_bytes;
+        };
+
+        struct StageReport
+        {
+            std::string stage;
+            Operation operation;
+            StageStatistics statistics;
+        };
+
+        struct AllocationCounts
+        {
+            u64 count;
+            u64 bytes;
+        };
+
+        // Returns the number of allocations performed so far by the calling thread. Without a probe,
+        // allocations are reported as zero; installing one is left to builds that can count them
+        typedef AllocationCounts (*AllocationProbe)();
+
+        void set_allocation_probe(AllocationProbe probe);
+
+        // Collects statistics of instrumented stages, summed per stage and operation.
+        // Can be shared by stages running on different threads
+        class Recorder
+        {
+        private:
+            std::atomic<bool> m_enabled;
+            mutable std::mutex m_mutex;
+            std::vector<StageReport> m_reports;
+            std::function<void(const StageReport&)> m_callback;
+
+        public:
+            Recorder();
+
+            // callback receives the statistics of every single call as it completes
+            Recorder(std::function<void(const StageReport&)> callback);
+
+            // While disabled, instrumented stages forward to the wrapped encoding without measuring anything
+            bool enabled() const
+            {
+                return m_enabled.load(std::memory_order_relaxed);
+            }
+
+            void enable();
+            void disable();
+
+            void record(const std::string& stage, Operation operation, const StageStatistics& statistics);
+
+            // Stages appear in the order in which they first completed a call
+            std::vector<StageReport> report() const;
+
+            void clear();
+        };
+
+        std::string to_json(const std::vector<StageReport>& reports);
+
+        std::shared_ptr<EncodingImplementation> create_instrumented_implementation(std::shared_ptr<EncodingImplementation> implementation, const std::string& stage, std::shared_ptr<Recorder> recorder);
+    }
+
+    // Behaves like encoding, but reports to recorder under the name stage.
+    // Instrument each stage separately, e.g. instrumented(a, "a", r) | instrumented(b, "b", r), to see where time goes
+    template<u64 IN, u64 OUT>
+    Encoding<IN, OUT> instrumented(Encoding<IN, OUT> encoding, const std::string& stage, std::shared_ptr<instrumentation::Recorder> recorder)
+    {
+        return Encoding<IN, OUT>(instrumentation::create_instrumented_implementation(encoding.implementation(), stage, recorder));
+    }
+}
+
+#endif
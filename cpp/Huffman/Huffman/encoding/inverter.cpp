@@ -23,6 +23,12 @@ namespace
         {
             m_encoding->encode(input, output);
         }
+
+        u64 max_encoded_size(u64) const override
+        {
+            // Encodings only bound the size of their encoded output, not that of their decoded output
+            return encoding::UNBOUNDED;
+        }
     };
 }
 
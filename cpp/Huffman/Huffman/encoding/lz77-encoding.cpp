@@ -0,0 +1,302 @@
+#include "encoding/lz77-encoding.h"
+#include "io/io-util.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+    constexpr u64 MIN_MATCH = 3;
+    constexpr u64 MAX_MATCH = 258;
+
+    constexpr unsigned HASH_BITS = 15;
+    constexpr u64 HASH_SIZE = u64(1) << HASH_BITS;
+
+    // Limits the number of candidates examined per position, bounding the worst case on repetitive data
+    constexpr unsigned MAX_CHAIN = 64;
+
+    constexpr u64 NONE = std::numeric_limits<u64>::max();
+
+    unsigned digits_needed(u64 count, u64 base)
+    {
+        unsigned result = 0;
+        u64 capacity = 1;
+
+        while (capacity < count)
+        {
+            capacity *= base;
+            ++result;
+        }
+
+        return result;
+    }
+
+    // Copies length data from distance positions back; source and destination may overlap.
+    // Each copy is non-overlapping and the copied region doubles every iteration
+    template<typename T>
+    void copy_match(T* destination, u64 distance, u64 length)
+    {
+        const T* source = destination - distance;
+
+        while (length > 0)
+        {
+            auto chunk = std::min<u64>(length, destination - source);
+            std::memcpy(destination, source, chunk * sizeof(T));
+            destination += chunk;
+            length -= chunk;
+        }
+    }
+
+    class Lz77EncodingImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        u64 m_domain_size;
+        u64 m_window_size;
+        Datum m_marker;
+        unsigned m_length_digits;
+        unsigned m_distance_digits;
+
+    public:
+        Lz77EncodingImplementation(u64 domain_size, unsigned window_size)
+            : m_domain_size(domain_size)
+            , m_window_size(window_size)
+            , m_marker(domain_size)
+            , m_length_digits(digits_needed(MAX_MATCH - MIN_MATCH + 1, domain_size))
+            , m_distance_digits(digits_needed(window_size, domain_size))
+        {
+            assert(window_size > 0);
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            with_integer_type_for_domain_size(m_domain_size, [&](auto type) {
+                encode_data(io::read_all<decltype(type)>(input), output);
+            });
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            auto valid = with_integer_type_for_domain_size(m_domain_size, [&](auto type) {
+                return decode_data<decltype(type)>(input, output);
+            });
+
+            if (!valid)
+            {
+                input.fail();
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            // A match of MIN_MATCH data can take more room than the data it replaces
+            auto match_size = 1 + m_length_digits + m_distance_digits;
+
+            return std::max(input_size, (input_size * match_size + MIN_MATCH - 1) / MIN_MATCH);
+        }
+
+    private:
+        template<typename T>
+        void encode_data(const std::vector<T>& data, io::OutputStream& output) const
+        {
+            std::vector<u64> head(HASH_SIZE, NONE);
+            std::vector<u64> previous(m_window_size, NONE);
+            u64 position = 0;
+
+            while (position < data.size())
+            {
+                u64 best_length = 0;
+                u64 best_distance = 0;
+
+                find_longest_match(data, head, previous, position, &best_length, &best_distance);
+
+                if (best_length >= MIN_MATCH)
+                {
+                    output.write(m_marker);
+                    write_digits(best_length - MIN_MATCH, m_length_digits, output);
+                    write_digits(best_distance - 1, m_distance_digits, output);
+
+                    for (u64 i = 0; i != best_length; ++i)
+                    {
+                        insert(data, head, previous, position + i);
+                    }
+
+                    position += best_length;
+                }
+                else
+                {
+                    output.write(data[position]);
+                    insert(data, head, previous, position);
+                    ++position;
+                }
+            }
+        }
+
+        // Returns false on the first match that cannot have been written by encode
+        template<typename T>
+        bool decode_data(io::InputStream& input, io::OutputStream& output) const
+        {
+            std::vector<T> history;
+
+            while (!input.end_reached())
+            {
+                auto datum = input.read();
+                auto start = history.size();
+
+                if (datum == m_marker)
+                {
+                    u64 length, distance;
+
+                    if (!read_digits(m_length_digits, input, &length) || !read_digits(m_distance_digits, input, &distance))
+                    {
+                        return false;
+                    }
+
+                    length += MIN_MATCH;
+                    distance += 1;
+
+                    if (length > MAX_MATCH || distance > std::min(m_window_size, u64(history.size())))
+                    {
+                        return false;
+                    }
+
+                    history.resize(start + length);
+                    copy_match(history.data() + start, distance, length);
+                }
+                else if (datum < m_domain_size)
+                {
+                    history.push_back(T(datum));
+                }
+                else
+                {
+                    return false;
+                }
+
+                for (auto i = start; i != history.size(); ++i)
+                {
+                    output.write(history[i]);
+                }
+
+                // Only the last window is ever referred to; drop the rest once it gets large
+                if (history.size() > 2 * (m_window_size + MAX_MATCH))
+                {
+                    history.erase(history.begin(), history.end() - m_window_size);
+                }
+            }
+
+            return true;
+        }
+
+        template<typename T>
+        u64 hash(const std::vector<T>& data, u64 position) const
+        {
+            u64 h = data[position] * 0x9E3779B97F4A7C15ull;
+            h = (h ^ data[position + 1]) * 0x9E3779B97F4A7C15ull;
+            h = (h ^ data[position + 2]) * 0x9E3779B97F4A7C15ull;
+
+            return h >> (64 - HASH_BITS);
+        }
+
+        template<typename T>
+        void insert(const std::vector<T>& data, std::vector<u64>& head, std::vector<u64>& previous, u64 position) const
+        {
+            if (position + MIN_MATCH <= data.size())
+            {
+                auto h = hash(data, position);
+                previous[position % m_window_size] = head[h];
+                head[h] = position;
+            }
+        }
+
+        template<typename T>
+        void find_longest_match(const std::vector<T>& data, const std::vector<u64>& head, const std::vector<u64>& previous, u64 position, u64* best_length, u64* best_distance) const
+        {
+            if (position + MIN_MATCH > data.size())
+            {
+                return;
+            }
+
+            auto max_length = std::min<u64>(MAX_MATCH, data.size() - position);
+            auto candidate = head[hash(data, position)];
+            unsigned chain = MAX_CHAIN;
+
+            while (candidate != NONE && position - candidate <= m_window_size && chain-- > 0)
+            {
+                u64 length = 0;
+
+                while (length < max_length && data[candidate + length] == data[position + length])
+                {
+                    ++length;
+                }
+
+                if (length > *best_length)
+                {
+                    *best_length = length;
+                    *best_distance = position - candidate;
+
+                    if (length == max_length)
+                    {
+                        return;
+                    }
+                }
+
+                auto next = previous[candidate % m_window_size];
+
+                if (next == NONE || next >= candidate)
+                {
+                    return;
+                }
+
+                candidate = next;
+            }
+        }
+
+        void write_digits(u64 value, unsigned ndigits, io::OutputStream& output) const
+        {
+            for (unsigned i = 0; i != ndigits; ++i)
+            {
+                output.write(value % m_domain_size);
+                value /= m_domain_size;
+            }
+
+            assert(value == 0);
+        }
+
+        // Fails on truncation and on digits outside the domain (such as the marker)
+        bool read_digits(unsigned ndigits, io::InputStream& input, u64* result) const
+        {
+            u64 weight = 1;
+
+            *result = 0;
+
+            for (unsigned i = 0; i != ndigits; ++i)
+            {
+                if (input.end_reached())
+                {
+                    return false;
+                }
+
+                auto digit = input.read();
+
+                if (digit >= m_domain_size)
+                {
+                    return false;
+                }
+
+                *result += digit * weight;
+                weight *= m_domain_size;
+            }
+
+            return true;
+        }
+    };
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_lz77_implementation(u64 domain_size, unsigned window_size)
+{
+    return std::make_shared<Lz77EncodingImplementation>(domain_size, window_size);
+}
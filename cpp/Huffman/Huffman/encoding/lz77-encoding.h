@@ -0,0 +1,24 @@
+#ifndef LZ77_ENCODING_H
+#define LZ77_ENCODING_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <memory>
+
+
+namespace encoding
+{
+    std::shared_ptr<EncodingImplementation> create_lz77_implementation(u64 domain_size, unsigned window_size);
+
+    // Literals are passed through as is, matches are announced by the extra datum N
+    // followed by their length and distance written as base N digits
+    template<u64 N>
+    Encoding<N, N + 1> lz77(unsigned window_size = 32768)
+    {
+        static_assert(N >= 2, "lz77 needs at least two digits to write lengths and distances");
+
+        return encoding::Encoding<N, N + 1>(create_lz77_implementation(N, window_size));
+    }
+}
+
+#endif
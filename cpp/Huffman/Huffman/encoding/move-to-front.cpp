@@ -1,6 +1,5 @@
 #include "encoding/move-to-front.h"
 #include "util.h"
-#include <deque>
 #include <assert.h>
 #include <numeric>
 #include <memory>
@@ -8,56 +7,6 @@
 
 namespace
 {
-    class MoveToFrontEncodingImplementation : public encoding::EncodingImplementation
-    {
-        u64 domain_size;
-
-    public:
-        MoveToFrontEncodingImplementation(u64 domain_size) : domain_size(domain_size)
-        {
-            // NOP
-        }
-
-        virtual void encode(io::InputStream& input, io::OutputStream& output) const override
-        {
-            std::deque<Datum> table;
-            add_range<Datum>(table, 0, this->domain_size);
-
-            while ( !input.end_reached() )
-            {
-                auto datum = input.read();
-                unsigned index = 0;
-                auto it = table.begin();
-
-                while (*it != datum)
-                {
-                    ++it;
-                    ++index;
-                }
-
-                table.erase(it);
-                table.push_front(datum);
-                output.write(index);
-            }
-        }
-
-        virtual void decode(io::InputStream& indices, io::OutputStream& result) const override
-        {
-            std::deque<Datum> table;
-            add_range<Datum>(table, 0, this->domain_size);
-
-            while (!indices.end_reached())
-            {
-                auto index = indices.read();
-                auto datum = table[index];
-
-                table.erase(table.begin() + index);
-                table.push_front(datum);
-                result.write(datum);
-            }
-        }
-    };
-
     struct NODE
     {
         Datum datum;
@@ -122,6 +71,11 @@ namespace
             }
         }
 
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            return input_size;
+        }
+
     private:
         std::unique_ptr<NODE[]> create_initial_table() const
         {
@@ -138,11 +92,6 @@ namespace
     };
 }
 
-std::shared_ptr<encoding::EncodingImplementation> encoding::create_move_to_front_encoding_implementation(u64 domain_size)
-{
-    return std::make_shared<MoveToFrontEncodingImplementation>(domain_size);
-}
-
 std::shared_ptr<encoding::EncodingImplementation> encoding::create_move_to_front_encoding_fast_implementation(u64 domain_size)
 {
     return std::make_shared<MoveToFrontEncodingFastImplementation>(domain_size);
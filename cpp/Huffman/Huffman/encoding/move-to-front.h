@@ -3,17 +3,17 @@
 
 #include "util.h"
 #include "encoding/encoding.h"
+#include "encoding/fused/move-to-front.h"
 #include <memory>
 
 namespace encoding
 {
-    std::shared_ptr<encoding::EncodingImplementation> create_move_to_front_encoding_implementation(u64 domain_size);
     std::shared_ptr<encoding::EncodingImplementation> create_move_to_front_encoding_fast_implementation(u64 domain_size);
 
     template<unsigned N>
     encoding::Encoding<N, N> move_to_front()
     {
-        return Encoding<N, N>(create_move_to_front_encoding_implementation(N));
+        return fused::to_encoding(fused::move_to_front<N>);
     }
 
     template<unsigned N>
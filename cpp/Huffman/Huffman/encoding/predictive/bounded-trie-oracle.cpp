@@ -0,0 +1,102 @@
+#include "encoding/predictive/bounded-trie-oracle.h"
+#include "encoding/predictive/oracle.h"
+#include "data/arena-trie.h"
+#include <assert.h>
+#include <memory>
+#include <vector>
+#include "util.h"
+
+
+namespace
+{
+    class BoundedTrieOracle : public encoding::predictive::Oracle
+    {
+    private:
+        typedef data::ArenaTrie<Datum, u64> trie;
+
+        trie m_trie;
+        unsigned m_max_depth;
+        std::vector<trie::node> m_contexts;
+
+    public:
+        BoundedTrieOracle(unsigned max_depth, size_t memory_budget) : m_trie(trie::capacity_for_budget(memory_budget)), m_max_depth(max_depth)
+        {
+            // Room for the root and one full update
+            assert(m_trie.capacity() > max_depth + 1);
+
+            m_contexts.reserve(max_depth);
+        }
+
+        void reset() override
+        {
+            m_trie.clear();
+            m_contexts.clear();
+        }
+
+        void tell(Datum datum) override
+        {
+            // A single update creates at most max_depth + 1 nodes. Checking up front makes the
+            // decision to start over depend only on the data seen so far, so encoder and decoder agree
+            if (m_trie.size() + m_max_depth + 1 > m_trie.capacity())
+            {
+                reset();
+            }
+
+            auto old_size = m_contexts.size();
+
+            if (old_size < m_max_depth)
+            {
+                m_contexts.push_back(trie::none);
+            }
+
+            for (size_t k = old_size; k-- > 0; )
+            {
+                auto child = extend(m_contexts[k], datum);
+
+                if (k + 1 < m_max_depth)
+                {
+                    m_contexts[k + 1] = child;
+                }
+            }
+
+            auto child = extend(trie::root, datum);
+
+            if (m_max_depth > 0)
+            {
+                m_contexts[0] = child;
+            }
+        }
+
+        Datum predict() const override
+        {
+            for (size_t k = m_contexts.size(); k-- > 0; )
+            {
+                auto context = m_contexts[k];
+
+                if (m_trie.has_children(context))
+                {
+                    return m_trie.maximum_key(context);
+                }
+            }
+
+            return 0;
+        }
+
+    private:
+        trie::node extend(trie::node context, Datum datum)
+        {
+            auto child = m_trie.child(context, datum);
+            assert(child != trie::none);
+
+            m_trie.data(child)++;
+            m_trie.update_maximum(context, child, datum);
+
+            return child;
+        }
+    };
+}
+
+std::unique_ptr<encoding::predictive::Oracle> encoding::predictive::bounded_trie_oracle(unsigned max_depth, size_t memory_budget)
+{
+    return std::make_unique<BoundedTrieOracle>(max_depth, memory_budget);
+}
@@ -0,0 +1,18 @@
+#ifndef BOUNDED_TRIE_ORACLE_H
+#define BOUNDED_TRIE_ORACLE_H
+
+#include "encoding/predictive/oracle.h"
+#include <memory>
+
+
+namespace encoding
+{
+    namespace predictive
+    {
+        // Predicts like trie_oracle, but never uses more than memory_budget bytes:
+        // when the trie fills up, it is emptied and learning starts over
+        std::unique_ptr<Oracle> bounded_trie_oracle(unsigned max_depth, size_t memory_budget);
+    }
+}
+
+#endif
@@ -0,0 +1,203 @@
+#include "encoding/predictive/hashed-context-oracle.h"
+#include "encoding/predictive/oracle.h"
+#include "data/context-table.h"
+#include "io/memory-mapped-file.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "util.h"
+
+
+namespace
+{
+    constexpr u64 HASH_BASE = 0x100000001B3ull;
+
+    constexpr char MODEL_MAGIC[8] = { 'H', 'U', 'F', 'F', 'C', 'T', 'X', '1' };
+    constexpr uint32_t MODEL_VERSION = 1;
+
+    // Padded to a cache line so that the slots following it are aligned like the ones of a ContextTable
+    struct ModelHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t order;
+        uint32_t table_bits;
+        uint8_t padding[44];
+    };
+
+    static_assert(sizeof(ModelHeader) == data::ContextTable::CACHE_LINE_SIZE, "Header should occupy exactly one cache line");
+
+    class HashedContextOracle : public encoding::predictive::Oracle
+    {
+    private:
+        data::ContextTable m_table;
+
+        // Last order data, each stored as datum + 1 so that positions before the start hash differently from datum 0
+        std::vector<u64> m_history;
+        size_t m_oldest;
+
+        // Sum of m_history[i] * HASH_BASE^age(i), updated incrementally
+        u64 m_hash;
+        u64 m_oldest_weight;
+
+    public:
+        HashedContextOracle(unsigned order, unsigned table_bits) : HashedContextOracle(order, table_bits, nullptr)
+        {
+            // NOP
+        }
+
+        HashedContextOracle(unsigned order, unsigned table_bits, const data::ContextTable::Slot* base) : m_table(table_bits, base), m_history(order, 0), m_oldest(0), m_hash(0), m_oldest_weight(1)
+        {
+            assert(order > 0);
+
+            for (unsigned i = 1; i < order; ++i)
+            {
+                m_oldest_weight *= HASH_BASE;
+            }
+        }
+
+        void reset() override
+        {
+            m_table.clear();
+            std::fill(m_history.begin(), m_history.end(), 0);
+            m_oldest = 0;
+            m_hash = 0;
+        }
+
+        void tell(Datum datum) override
+        {
+            m_table.update(m_hash, datum);
+
+            auto value = datum + 1;
+            m_hash = (m_hash - m_history[m_oldest] * m_oldest_weight) * HASH_BASE + value;
+            m_history[m_oldest] = value;
+            m_oldest = (m_oldest + 1) % m_history.size();
+        }
+
+        Datum predict() const override
+        {
+            Datum prediction;
+            unsigned confidence;
+
+            if (m_table.lookup(m_hash, &prediction, &confidence))
+            {
+                return prediction;
+            }
+
+            return 0;
+        }
+
+        const data::ContextTable& table() const
+        {
+            return m_table;
+        }
+    };
+
+    class PretrainedContextOracle : public HashedContextOracle
+    {
+    private:
+        // Keeps the mapping alive for as long as the table refers to it
+        std::shared_ptr<const encoding::predictive::ContextModel> m_model;
+
+    public:
+        PretrainedContextOracle(std::shared_ptr<const encoding::predictive::ContextModel> model);
+    };
+}
+
+class encoding::predictive::ContextModel
+{
+private:
+    io::MemoryMappedFile m_file;
+
+public:
+    ContextModel(const std::string& path) : m_file(path)
+    {
+        // NOP
+    }
+
+    // Files come from outside, so all of this is checked before the header is trusted
+    bool valid() const
+    {
+        return m_file.is_open()
+            && m_file.size() >= sizeof(ModelHeader)
+            && std::memcmp(header().magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) == 0
+            && header().version == MODEL_VERSION
+            && header().order > 0
+            && header().table_bits <= data::ContextTable::MAX_TABLE_BITS
+            && m_file.size() == sizeof(ModelHeader) + (size_t(1) << header().table_bits) * sizeof(data::ContextTable::Slot);
+    }
+
+    unsigned order() const
+    {
+        return header().order;
+    }
+
+    unsigned table_bits() const
+    {
+        return header().table_bits;
+    }
+
+    const data::ContextTable::Slot* slots() const
+    {
+        return reinterpret_cast<const data::ContextTable::Slot*>(m_file.data() + sizeof(ModelHeader));
+    }
+
+private:
+    const ModelHeader& header() const
+    {
+        return *reinterpret_cast<const ModelHeader*>(m_file.data());
+    }
+};
+
+PretrainedContextOracle::PretrainedContextOracle(std::shared_ptr<const encoding::predictive::ContextModel> model)
+    : HashedContextOracle(model->order(), model->table_bits(), model->slots()), m_model(model)
+{
+    // NOP
+}
+
+std::unique_ptr<encoding::predictive::Oracle> encoding::predictive::hashed_context_oracle(unsigned order, unsigned table_bits)
+{
+    return std::make_unique<HashedContextOracle>(order, table_bits);
+}
+
+bool encoding::predictive::train_context_model(const std::vector<Datum>& corpus, unsigned order, unsigned table_bits, const std::string& path)
+{
+    HashedContextOracle oracle(order, table_bits);
+
+    for (auto datum : corpus)
+    {
+        oracle.tell(datum);
+    }
+
+    ModelHeader header = { };
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    header.version = MODEL_VERSION;
+    header.order = order;
+    header.table_bits = table_bits;
+
+    std::ofstream file(path, std::ios::binary);
+    auto& table = oracle.table();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.slots()), table.size() * sizeof(data::ContextTable::Slot));
+    file.close();
+
+    return !file.fail();
+}
+
+std::shared_ptr<const encoding::predictive::ContextModel> encoding::predictive::load_context_model(const std::string& path)
+{
+    auto model = std::make_shared<ContextModel>(path);
+
+    return model->valid() ? model : nullptr;
+}
+
+std::unique_ptr<encoding::predictive::Oracle> encoding::predictive::pretrained_context_oracle(std::shared_ptr<const ContextModel> model)
+{
+    assert(model != nullptr);
+
+    return std::make_unique<PretrainedContextOracle>(model);
+}
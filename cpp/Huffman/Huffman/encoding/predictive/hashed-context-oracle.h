@@ -0,0 +1,40 @@
+#ifndef HASHED_CONTEXT_ORACLE_H
+#define HASHED_CONTEXT_ORACLE_H
+
+#include "encoding/predictive/oracle.h"
+#include "util.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace encoding
+{
+    namespace predictive
+    {
+        // Predicts a datum that followed the same order data, remembered in a table of 2^table_bits slots.
+        // Each slot counts how often its prediction came true: a hit raises the count (up to 255), a miss
+        // lowers it, and only when it reaches zero does the datum that just followed become the prediction.
+        // A context that hashes to a slot held by another context takes it over outright.
+        // Memory use is fixed, regardless of order
+        std::unique_ptr<Oracle> hashed_context_oracle(unsigned order, unsigned table_bits);
+
+        // Table of a hashed context oracle trained on a sample corpus, mapped read-only from a file
+        class ContextModel;
+
+        // Feeds corpus to a hashed context oracle and saves its table. The file is a fixed header followed
+        // by the raw slots, so that it can be mapped and used as is (it is specific to the machine's byte order).
+        // Returns false if the file could not be written
+        bool train_context_model(const std::vector<Datum>& corpus, unsigned order, unsigned table_bits, const std::string& path);
+
+        // Returns nullptr if the file is missing, was not written by train_context_model or is damaged
+        std::shared_ptr<const ContextModel> load_context_model(const std::string& path);
+
+        // Hashed context oracle that starts out in the model's trained state. Updates are kept
+        // in a private copy of the modified cache lines only, which reset() discards again,
+        // so that even short messages benefit from the model and the model itself is shared
+        std::unique_ptr<Oracle> pretrained_context_oracle(std::shared_ptr<const ContextModel> model);
+    }
+}
+
+#endif
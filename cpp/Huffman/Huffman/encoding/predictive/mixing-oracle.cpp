@@ -0,0 +1,163 @@
+#include "encoding/predictive/mixing-oracle.h"
+#include "encoding/predictive/oracle.h"
+#include "data/context-table.h"
+#include <assert.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "util.h"
+
+
+namespace
+{
+    constexpr u64 HASH_BASE = 0x100000001B3ull;
+    constexpr u64 ORDER_SALT = 0x9E3779B97F4A7C15ull;
+
+    // Hit rates are running averages in 16 bit fixed point; each observation moves them by 1/2^RATE_SHIFT
+    constexpr unsigned RATE_SHIFT = 4;
+    constexpr u64 RATE_ONE = u64(1) << 16;
+
+    // Beyond this, a context's own confidence stops adding weight to its vote
+    constexpr unsigned CONFIDENCE_CAP = 16;
+
+    class MixingOracle : public encoding::predictive::Oracle
+    {
+    private:
+        data::ContextTable m_table;
+        unsigned m_max_order;
+
+        // Most recent data (plus one), newest at m_history[m_newest]
+        std::vector<u64> m_history;
+        size_t m_newest;
+        unsigned m_available_orders;
+
+        // m_hashes[k] identifies the context of order k + 1
+        std::vector<u64> m_hashes;
+        std::vector<u64> m_hit_rates;
+
+        struct Vote
+        {
+            Datum datum;
+            u64 weight;
+        };
+
+        mutable std::vector<Vote> m_votes;
+
+    public:
+        MixingOracle(unsigned max_order, unsigned table_bits) : m_table(table_bits), m_max_order(max_order), m_history(max_order, 0), m_hashes(max_order, 0), m_hit_rates(max_order, 0)
+        {
+            assert(max_order > 0);
+
+            m_votes.reserve(max_order);
+            reset();
+        }
+
+        void reset() override
+        {
+            m_table.clear();
+            std::fill(m_history.begin(), m_history.end(), 0);
+            m_newest = 0;
+            m_available_orders = 0;
+
+            // Start out favoring longer contexts slightly
+            for (unsigned k = 0; k != m_max_order; ++k)
+            {
+                m_hit_rates[k] = RATE_ONE / 2 + k;
+            }
+        }
+
+        void tell(Datum datum) override
+        {
+            for (unsigned k = 0; k != m_available_orders; ++k)
+            {
+                Datum prediction;
+                unsigned confidence;
+
+                if (m_table.lookup(m_hashes[k], &prediction, &confidence))
+                {
+                    update_hit_rate(k, prediction == datum);
+                }
+
+                m_table.update(m_hashes[k], datum);
+            }
+
+            m_newest = (m_newest + 1) % m_max_order;
+            m_history[m_newest] = datum + 1;
+            m_available_orders = std::min(m_available_orders + 1, m_max_order);
+
+            compute_hashes();
+        }
+
+        Datum predict() const override
+        {
+            m_votes.clear();
+
+            for (unsigned k = 0; k != m_available_orders; ++k)
+            {
+                Datum prediction;
+                unsigned confidence;
+
+                if (m_table.lookup(m_hashes[k], &prediction, &confidence))
+                {
+                    cast_vote(prediction, m_hit_rates[k] * std::min(confidence, CONFIDENCE_CAP));
+                }
+            }
+
+            if (m_votes.empty())
+            {
+                return 0;
+            }
+
+            auto best = std::max_element(m_votes.begin(), m_votes.end(), [](const Vote& v, const Vote& w) { return v.weight < w.weight; });
+
+            return best->datum;
+        }
+
+    private:
+        void compute_hashes()
+        {
+            u64 hash = 0;
+            auto index = m_newest;
+
+            for (unsigned k = 0; k != m_available_orders; ++k)
+            {
+                hash = hash * HASH_BASE + m_history[index];
+                m_hashes[k] = hash + (k + 1) * ORDER_SALT;
+                index = (index + m_max_order - 1) % m_max_order;
+            }
+        }
+
+        void update_hit_rate(unsigned k, bool hit)
+        {
+            auto& rate = m_hit_rates[k];
+
+            if (hit)
+            {
+                rate += (RATE_ONE - rate) >> RATE_SHIFT;
+            }
+            else
+            {
+                rate -= rate >> RATE_SHIFT;
+            }
+        }
+
+        void cast_vote(Datum datum, u64 weight) const
+        {
+            for (auto& vote : m_votes)
+            {
+                if (vote.datum == datum)
+                {
+                    vote.weight += weight;
+                    return;
+                }
+            }
+
+            m_votes.push_back(Vote{ datum, weight });
+        }
+    };
+}
+
+std::unique_ptr<encoding::predictive::Oracle> encoding::predictive::mixing_oracle(unsigned max_order, unsigned table_bits)
+{
+    return std::make_unique<MixingOracle>(max_order, table_bits);
+}
@@ -0,0 +1,19 @@
+#ifndef MIXING_ORACLE_H
+#define MIXING_ORACLE_H
+
+#include "encoding/predictive/oracle.h"
+#include <memory>
+
+
+namespace encoding
+{
+    namespace predictive
+    {
+        // Consults contexts of orders 1 to max_order, all stored in one table of 2^table_bits slots,
+        // and lets them vote on the prediction. Each vote is weighted by how often that order
+        // has been right lately and how confident it is about this particular context
+        std::unique_ptr<Oracle> mixing_oracle(unsigned max_order, unsigned table_bits);
+    }
+}
+
+#endif
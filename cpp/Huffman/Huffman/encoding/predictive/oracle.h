@@ -2,6 +2,8 @@
 #define ORACLE_H
 
 #include "util.h"
+#include <functional>
+#include <memory>
 
 
 namespace encoding
@@ -17,6 +19,10 @@ namespace encoding
             virtual void tell(Datum datum)   = 0;
             virtual Datum predict() const    = 0;
         };
+
+        // Oracles are stateful, so encodings create a fresh one for every call to encode/decode
+        // rather than sharing a single instance. This allows an encoding to be used from several threads at once
+        typedef std::function<std::unique_ptr<Oracle>()> OracleFactory;
     }
 }
 
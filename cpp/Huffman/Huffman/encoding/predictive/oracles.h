@@ -4,5 +4,8 @@
 #include "encoding/predictive/constant-oracle.h"
 #include "encoding/predictive/repeating-oracle.h"
 #include "encoding/predictive/trie-oracle.h"
+#include "encoding/predictive/bounded-trie-oracle.h"
+#include "encoding/predictive/hashed-context-oracle.h"
+#include "encoding/predictive/mixing-oracle.h"
 
 #endif
@@ -8,23 +8,23 @@ namespace
     {
     private:
         u64 m_domain_size;
-        std::unique_ptr<encoding::predictive::Oracle> m_oracle;
+        encoding::predictive::OracleFactory m_oracle_factory;
 
     public:
-        PredictiveEncodingImplementation(u64 domain_size, std::unique_ptr<encoding::predictive::Oracle> oracle) : m_domain_size(domain_size), m_oracle(std::move(oracle))
+        PredictiveEncodingImplementation(u64 domain_size, encoding::predictive::OracleFactory oracle_factory) : m_domain_size(domain_size), m_oracle_factory(oracle_factory)
         {
-            // NOP
+            assert(m_oracle_factory);
         }
 
         void encode(io::InputStream& input, io::OutputStream& output) const override
         {
-            m_oracle->reset();
+            auto oracle = m_oracle_factory();
 
             while (!input.end_reached())
             {
                 auto actual_datum = input.read();
-                auto predicted_datum = m_oracle->predict();
-                m_oracle->tell(actual_datum);
+                auto predicted_datum = oracle->predict();
+                oracle->tell(actual_datum);
                 auto correction = correct(actual_datum, predicted_datum);
                 output.write(correction);
             }
@@ -32,18 +32,23 @@ namespace
 
         void decode(io::InputStream& input, io::OutputStream& output) const override
         {
-            m_oracle->reset();
+            auto oracle = m_oracle_factory();
 
             while (!input.end_reached())
             {
                 auto correction = input.read();
-                auto predicted_datum = m_oracle->predict();
+                auto predicted_datum = oracle->predict();
                 auto datum = apply_correction(predicted_datum, correction);
-                m_oracle->tell(datum);
+                oracle->tell(datum);
                 output.write(datum);
             }
         }
 
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            return input_size;
+        }
+
     private:
         Datum correct(Datum actual_datum, Datum predicted_datum) const
         {
@@ -71,7 +76,7 @@ namespace
     };
 }
 
-std::shared_ptr<encoding::EncodingImplementation> encoding::create_predictive_encoding_implementation(u64 domain_size, std::unique_ptr<encoding::predictive::Oracle> oracle)
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_predictive_encoding_implementation(u64 domain_size, encoding::predictive::OracleFactory oracle_factory)
 {
-    return std::make_shared<PredictiveEncodingImplementation>(domain_size, std::move(oracle));
+    return std::make_shared<PredictiveEncodingImplementation>(domain_size, oracle_factory);
 }
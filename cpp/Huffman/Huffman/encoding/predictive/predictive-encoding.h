@@ -8,12 +8,12 @@
 
 namespace encoding
 {
-    std::shared_ptr<EncodingImplementation> create_predictive_encoding_implementation(u64 domain_size, std::unique_ptr<encoding::predictive::Oracle> oracle);
+    std::shared_ptr<EncodingImplementation> create_predictive_encoding_implementation(u64 domain_size, encoding::predictive::OracleFactory oracle_factory);
 
     template<u64 N>
-    Encoding<N, N> predictive_encoding(std::unique_ptr<encoding::predictive::Oracle> oracle)
+    Encoding<N, N> predictive_encoding(encoding::predictive::OracleFactory oracle_factory)
     {
-        return encoding::Encoding<N, N>(create_predictive_encoding_implementation(N, std::move(oracle)));
+        return encoding::Encoding<N, N>(create_predictive_encoding_implementation(N, oracle_factory));
     }
 }
 
@@ -1,9 +1,8 @@
 #include "encoding/predictive/trie-oracle.h"
 #include "encoding/predictive/oracle.h"
 #include "data/trie.h"
-#include <algorithm>
 #include <memory>
-#include <deque>
+#include <vector>
 #include "util.h"
 
 
@@ -16,65 +15,68 @@ namespace
 
         std::unique_ptr<trie> m_trie;
         unsigned m_max_depth;
-        std::deque<Datum> m_queue;
+
+        // m_contexts[k] is the node reached by following the last k + 1 data from the root.
+        // Keeping these cursors around avoids walking the trie from the root for every suffix
+        std::vector<trie*> m_contexts;
 
     public:
         TrieOracle(unsigned max_depth) : m_max_depth(max_depth), m_trie(std::make_unique<trie>())
         {
-            // NOP
+            m_contexts.reserve(max_depth);
         }
 
         void reset() override
         {
             m_trie = std::make_unique<trie>();
-            m_queue.clear();
+            m_contexts.clear();
         }
 
         void tell(Datum datum) override
         {
-            m_queue.push_back(datum);
+            auto old_size = m_contexts.size();
 
-            for (size_t n = 0; n < m_queue.size(); ++n)
-            {
-                auto trie = find_subtree(n);
-                trie->data++;
-            }
-            
-            if (m_queue.size() > m_max_depth)
+            if (old_size < m_max_depth)
             {
-                m_queue.pop_front();
+                m_contexts.push_back(nullptr);
             }
-        }
 
-        Datum predict() const override
-        {
-            for (size_t i = 0; i != m_queue.size(); ++i)
+            // Extend every context by datum, longest first so that m_contexts[k] is read before it is overwritten
+            for (size_t k = old_size; k-- > 0; )
             {
-                auto subtree = find_subtree(i);
-                auto keys = subtree->keys();
+                auto& child = (*m_contexts[k])[datum];
+                child.data++;
+                m_contexts[k]->update_maximum(datum);
 
-                if (keys.size() > 0)
+                if (k + 1 < m_max_depth)
                 {
-                    return *std::max_element(keys.begin(), keys.end(), [&](Datum k1, Datum k2) -> bool { return (*subtree)[k1].data < (*subtree)[k2].data; });
+                    m_contexts[k + 1] = &child;
                 }
             }
 
-            return 0;
-        }
+            auto& child = (*m_trie)[datum];
+            child.data++;
+            m_trie->update_maximum(datum);
 
+            if (m_max_depth > 0)
+            {
+                m_contexts[0] = &child;
+            }
+        }
 
-    private:
-        trie* find_subtree(size_t start_index) const
+        Datum predict() const override
         {
-            auto trie = m_trie.get();
-
-            for ( size_t i = start_index; i < m_queue.size(); ++i )
+            for (size_t k = m_contexts.size(); k-- > 0; )
             {
-                auto datum = m_queue[i];
-                trie = &(*trie)[datum];
+                auto context = m_contexts[k];
+
+                if (context->has_children())
+                {
+                    return context->maximum_key();
+                }
             }
 
-            return trie;
+            return 0;
         }
     };
 }
@@ -0,0 +1,293 @@
+#include "encoding/rans-encoding.h"
+#include "data/frequency-table.h"
+#include "io/binary-io.h"
+#include "io/io-util.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace
+{
+    // Frequencies are normalized so that they add up to 2^SCALE_BITS
+    constexpr unsigned SCALE_BITS = 14;
+    constexpr uint32_t SCALE = uint32_t(1) << SCALE_BITS;
+
+    // States are kept in [LOWER_BOUND, 256 * LOWER_BOUND)
+    constexpr uint32_t LOWER_BOUND = uint32_t(1) << 23;
+
+    // Consecutive symbols are spread over independent states so that their dependency chains can overlap
+    constexpr unsigned STATE_COUNT = 2;
+
+    struct Symbol
+    {
+        uint32_t start;
+        uint32_t frequency;
+    };
+
+    class RansEncodingImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        u64 m_domain_size;
+        unsigned m_bytes_per_datum;
+        unsigned m_bytes_per_count;
+
+    public:
+        RansEncodingImplementation(u64 domain_size) : m_domain_size(domain_size), m_bytes_per_datum(bytes_needed(domain_size)), m_bytes_per_count(bytes_needed(domain_size + 1))
+        {
+            // NOP
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            with_integer_type_for_domain_size(m_domain_size, [&](auto type) {
+                encode_data(io::read_all<decltype(type)>(input), output);
+            });
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            if (!decode_data(input, output))
+            {
+                input.fail();
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            auto header_size = 8 + m_bytes_per_count + std::min(input_size, m_domain_size) * (m_bytes_per_datum + 2);
+
+            // Every datum has frequency at least 1 and so adds at most SCALE_BITS bits to the states,
+            // plus a tiny rounding error (less than 1/256 bit each); the states themselves take 4 bytes each
+            auto payload_size = (input_size * SCALE_BITS + 7) / 8 + input_size / 256 + 1 + STATE_COUNT * 5;
+
+            return header_size + payload_size;
+        }
+
+    private:
+        template<typename T>
+        void encode_data(const std::vector<T>& copy, io::OutputStream& output) const
+        {
+            auto frequencies = data::count_frequencies_as<Datum>(copy);
+            auto values = frequencies.values();
+            auto normalized = normalize_frequencies(frequencies, values, copy.size());
+            auto symbols = create_symbols(values, normalized);
+
+            io::write_bytes(copy.size(), 8, output);
+            io::write_bytes(values.size(), m_bytes_per_count, output);
+
+            for (size_t i = 0; i != values.size(); ++i)
+            {
+                io::write_bytes(values[i], m_bytes_per_datum, output);
+                io::write_bytes(normalized[i], 2, output);
+            }
+
+            // rANS works as a stack: encode back to front and emit the bytes in reverse
+            std::vector<byte> reversed;
+            uint32_t states[STATE_COUNT];
+            std::fill(states, states + STATE_COUNT, LOWER_BOUND);
+
+            for (size_t i = copy.size(); i-- > 0; )
+            {
+                put(states[i % STATE_COUNT], symbols[copy[i]], reversed);
+            }
+
+            for (unsigned k = STATE_COUNT; k-- > 0; )
+            {
+                flush(states[k], reversed);
+            }
+
+            for (auto it = reversed.rbegin(); it != reversed.rend(); ++it)
+            {
+                output.write(*it);
+            }
+        }
+
+        // Returns false as soon as the header or the states turn out to be inconsistent, or the input runs out
+        bool decode_data(io::InputStream& input, io::OutputStream& output) const
+        {
+            auto size = io::read_bytes(8, input);
+            auto count = io::read_bytes(m_bytes_per_count, input);
+            std::vector<Datum> values;
+            std::vector<uint32_t> normalized;
+
+            if (count > std::min<u64>(m_domain_size, SCALE) || (count == 0) != (size == 0))
+            {
+                return false;
+            }
+
+            for (u64 i = 0; i != count; ++i)
+            {
+                values.push_back(io::read_bytes(m_bytes_per_datum, input));
+                normalized.push_back(uint32_t(io::read_bytes(2, input)));
+            }
+
+            if (input.failed() || !valid_frequencies(values, normalized))
+            {
+                return false;
+            }
+
+            auto symbols = create_symbols(values, normalized);
+            uint32_t states[STATE_COUNT];
+
+            for (unsigned k = 0; k != STATE_COUNT; ++k)
+            {
+                states[k] = uint32_t(io::read_bytes(4, input));
+
+                if (states[k] < LOWER_BOUND || states[k] >= 256 * LOWER_BOUND)
+                {
+                    return false;
+                }
+            }
+
+            // The slot table is looked up for every datum; keeping it compact keeps it in cache
+            return with_integer_type_for_domain_size(m_domain_size, [&](auto type) {
+                auto slots = create_slot_table<decltype(type)>(values, normalized);
+
+                // A single value takes no room at all, so size cannot be checked against the input;
+                // stop once the output has no room left either
+                for (u64 i = 0; i != size && !output.overflowed(); ++i)
+                {
+                    auto& state = states[i % STATE_COUNT];
+                    auto slot = state & (SCALE - 1);
+                    Datum datum = slots[slot];
+                    auto& symbol = symbols[datum];
+
+                    state = symbol.frequency * (state >> SCALE_BITS) + slot - symbol.start;
+
+                    while (state < LOWER_BOUND)
+                    {
+                        if (input.end_reached())
+                        {
+                            return false;
+                        }
+
+                        state = (state << 8) | uint32_t(input.read());
+                    }
+
+                    output.write(datum);
+                }
+
+                // Decoding retraces the encoder's steps, so the states end where the encoder started
+                return std::all_of(states, states + STATE_COUNT, [](uint32_t state) { return state == LOWER_BOUND; });
+            });
+        }
+
+        // Distinct values inside the domain, with nonzero frequencies adding up to SCALE
+        bool valid_frequencies(const std::vector<Datum>& values, const std::vector<uint32_t>& normalized) const
+        {
+            std::vector<bool> seen(m_domain_size, false);
+            u64 sum = 0;
+
+            for (size_t i = 0; i != values.size(); ++i)
+            {
+                if (values[i] >= m_domain_size || seen[values[i]] || normalized[i] == 0)
+                {
+                    return false;
+                }
+
+                seen[values[i]] = true;
+                sum += normalized[i];
+            }
+
+            return values.empty() || sum == SCALE;
+        }
+
+        std::vector<uint32_t> normalize_frequencies(const data::FrequencyTable<Datum>& frequencies, const std::vector<Datum>& values, u64 total) const
+        {
+            assert(values.size() <= SCALE);
+
+            std::vector<uint32_t> result;
+            u64 sum = 0;
+
+            for (auto& value : values)
+            {
+                // Every symbol that occurs needs a nonzero frequency, otherwise it cannot be encoded
+                auto frequency = std::max<u64>(1, frequencies[value] * SCALE / total);
+                result.push_back(uint32_t(frequency));
+                sum += frequency;
+            }
+
+            if (result.size() > 0)
+            {
+                while (sum > SCALE)
+                {
+                    auto largest = std::max_element(result.begin(), result.end());
+                    assert(*largest > 1);
+                    --*largest;
+                    --sum;
+                }
+
+                auto largest = std::max_element(result.begin(), result.end());
+                *largest += uint32_t(SCALE - sum);
+            }
+
+            return result;
+        }
+
+        std::vector<Symbol> create_symbols(const std::vector<Datum>& values, const std::vector<uint32_t>& normalized) const
+        {
+            std::vector<Symbol> result(m_domain_size, Symbol{ 0, 0 });
+            uint32_t start = 0;
+
+            for (size_t i = 0; i != values.size(); ++i)
+            {
+                assert(values[i] < m_domain_size);
+
+                result[values[i]] = Symbol{ start, normalized[i] };
+                start += normalized[i];
+            }
+
+            assert(values.size() == 0 || start == SCALE);
+
+            return result;
+        }
+
+        template<typename T>
+        std::vector<T> create_slot_table(const std::vector<Datum>& values, const std::vector<uint32_t>& normalized) const
+        {
+            std::vector<T> result;
+            result.reserve(SCALE);
+
+            for (size_t i = 0; i != values.size(); ++i)
+            {
+                result.insert(result.end(), normalized[i], T(values[i]));
+            }
+
+            result.resize(SCALE, 0);
+
+            return result;
+        }
+
+        void put(uint32_t& state, const Symbol& symbol, std::vector<byte>& reversed) const
+        {
+            assert(symbol.frequency > 0);
+
+            const uint32_t upper_bound = ((LOWER_BOUND >> SCALE_BITS) << 8) * symbol.frequency;
+
+            while (state >= upper_bound)
+            {
+                reversed.push_back(byte(state & 0xFF));
+                state >>= 8;
+            }
+
+            state = ((state / symbol.frequency) << SCALE_BITS) + (state % symbol.frequency) + symbol.start;
+        }
+
+        void flush(uint32_t state, std::vector<byte>& reversed) const
+        {
+            for (unsigned i = 0; i != 4; ++i)
+            {
+                reversed.push_back(byte(state & 0xFF));
+                state >>= 8;
+            }
+        }
+    };
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_rans_implementation(u64 domain_size)
+{
+    return std::make_shared<RansEncodingImplementation>(domain_size);
+}
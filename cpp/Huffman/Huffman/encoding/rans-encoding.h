@@ -0,0 +1,20 @@
+#ifndef RANS_ENCODING_H
+#define RANS_ENCODING_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <memory>
+
+
+namespace encoding
+{
+    std::shared_ptr<EncodingImplementation> create_rans_implementation(u64 domain_size);
+
+    template<u64 IN>
+    Encoding<IN, 256> rans_encoding()
+    {
+        return encoding::Encoding<IN, 256>(create_rans_implementation(IN));
+    }
+}
+
+#endif
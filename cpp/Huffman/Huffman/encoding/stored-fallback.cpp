@@ -0,0 +1,254 @@
+#include "encoding/stored-fallback.h"
+#include "data/frequency-table.h"
+#include "io/span-streams.h"
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+    constexpr Datum STORED = 0;
+    constexpr Datum ENCODED = 1;
+
+    // Blocks whose estimated size is within this fraction of their stored size are not worth encoding;
+    // the estimate ignores the overhead of the encoding (e.g. a Huffman tree), which eats up small savings
+    constexpr double ESTIMATE_THRESHOLD = 0.97;
+
+    unsigned digits_needed(u64 count, u64 base)
+    {
+        unsigned result = 0;
+        u64 capacity = 1;
+
+        while (capacity < count)
+        {
+            capacity *= base;
+            ++result;
+        }
+
+        return result;
+    }
+
+    // Order 0 entropy of the block in bits
+    double entropy(const std::vector<Datum>& block)
+    {
+        auto frequencies = data::count_frequencies(block);
+        double total = double(block.size());
+        double result = 0;
+
+        for (auto& datum : frequencies.values())
+        {
+            double frequency = double(frequencies[datum]);
+
+            result -= frequency * std::log2(frequency / total);
+        }
+
+        return result;
+    }
+
+    class StoredFallbackImplementation : public encoding::EncodingImplementation
+    {
+    private:
+        std::shared_ptr<encoding::EncodingImplementation> m_encoding;
+        u64 m_input_domain_size;
+        u64 m_output_domain_size;
+        u64 m_block_size;
+        bool m_estimate_entropy;
+        unsigned m_datum_digits;
+        unsigned m_size_digits;
+
+    public:
+        StoredFallbackImplementation(std::shared_ptr<encoding::EncodingImplementation> encoding, u64 input_domain_size, u64 output_domain_size, u64 block_size, bool estimate_entropy)
+            : m_encoding(encoding)
+            , m_input_domain_size(input_domain_size)
+            , m_output_domain_size(output_domain_size)
+            , m_block_size(block_size)
+            , m_estimate_entropy(estimate_entropy)
+            , m_datum_digits(digits_needed(input_domain_size, output_domain_size))
+            , m_size_digits(digits_needed(block_size * std::max(1u, m_datum_digits) + 1, output_domain_size))
+        {
+            assert(output_domain_size >= 2);
+            assert(block_size > 0);
+        }
+
+        void encode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            std::vector<Datum> block;
+            std::vector<Datum> encoded;
+
+            while (!input.end_reached())
+            {
+                block.clear();
+
+                while (block.size() < m_block_size && !input.end_reached())
+                {
+                    block.push_back(input.read());
+                }
+
+                encode_block(block, encoded, output);
+            }
+
+            // An empty block marks the end, so that padding added by later stages is ignored
+            output.write(STORED);
+            write_digits(0, m_size_digits, output);
+        }
+
+        void decode(io::InputStream& input, io::OutputStream& output) const override
+        {
+            if (!decode_blocks(input, output))
+            {
+                input.fail();
+            }
+        }
+
+        u64 max_encoded_size(u64 input_size) const override
+        {
+            // Blocks are only encoded if that makes them smaller than stored; the end is marked by an extra empty block
+            auto block_count = (input_size + m_block_size - 1) / m_block_size + 1;
+
+            return block_count * (1 + m_size_digits) + input_size * m_datum_digits;
+        }
+
+    private:
+        // Returns false on anything encode could not have written, including data that end before the empty block
+        bool decode_blocks(io::InputStream& input, io::OutputStream& output) const
+        {
+            std::vector<Datum> encoded;
+            io::SpanInputStream<Datum> block_input;
+
+            while (!input.end_reached())
+            {
+                auto flag = input.read();
+                u64 size;
+
+                if (!read_digits(m_size_digits, input, &size))
+                {
+                    return false;
+                }
+
+                if (flag == STORED && size == 0)
+                {
+                    return true;
+                }
+                else if (flag == STORED && size <= m_block_size)
+                {
+                    for (u64 i = 0; i != size; ++i)
+                    {
+                        u64 datum;
+
+                        if (!read_digits(m_datum_digits, input, &datum) || datum >= m_input_domain_size)
+                        {
+                            return false;
+                        }
+
+                        output.write(datum);
+                    }
+                }
+                else if (flag == ENCODED && size < m_block_size * m_datum_digits)
+                {
+                    encoded.clear();
+
+                    for (u64 i = 0; i != size; ++i)
+                    {
+                        if (input.end_reached())
+                        {
+                            return false;
+                        }
+
+                        encoded.push_back(input.read());
+                    }
+
+                    block_input.reset(encoded);
+                    m_encoding->decode(block_input, output);
+
+                    if (block_input.failed())
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return false;
+        }
+
+        void encode_block(const std::vector<Datum>& block, std::vector<Datum>& encoded, io::OutputStream& output) const
+        {
+            auto stored_size = block.size() * m_datum_digits;
+
+            if (!m_estimate_entropy || entropy(block) < ESTIMATE_THRESHOLD * double(stored_size) * std::log2(double(m_output_domain_size)))
+            {
+                io::SpanInputStream<Datum> block_input(block);
+                io::VectorOutputStream<Datum> block_output(encoded);
+
+                encoded.clear();
+                m_encoding->encode(block_input, block_output);
+
+                if (encoded.size() < stored_size)
+                {
+                    output.write(ENCODED);
+                    write_digits(encoded.size(), m_size_digits, output);
+
+                    for (auto datum : encoded)
+                    {
+                        output.write(datum);
+                    }
+
+                    return;
+                }
+            }
+
+            output.write(STORED);
+            write_digits(block.size(), m_size_digits, output);
+
+            for (auto datum : block)
+            {
+                assert(datum < m_input_domain_size);
+
+                write_digits(datum, m_datum_digits, output);
+            }
+        }
+
+        void write_digits(u64 value, unsigned ndigits, io::OutputStream& output) const
+        {
+            for (unsigned i = 0; i != ndigits; ++i)
+            {
+                output.write(value % m_output_domain_size);
+                value /= m_output_domain_size;
+            }
+
+            assert(value == 0);
+        }
+
+        bool read_digits(unsigned ndigits, io::InputStream& input, u64* result) const
+        {
+            u64 weight = 1;
+
+            *result = 0;
+
+            for (unsigned i = 0; i != ndigits; ++i)
+            {
+                if (input.end_reached())
+                {
+                    return false;
+                }
+
+                *result += input.read() * weight;
+                weight *= m_output_domain_size;
+            }
+
+            return true;
+        }
+    };
+}
+
+std::shared_ptr<encoding::EncodingImplementation> encoding::create_stored_fallback_implementation(std::shared_ptr<encoding::EncodingImplementation> encoding, u64 input_domain_size, u64 output_domain_size, u64 block_size, bool estimate_entropy)
+{
+    return std::make_shared<StoredFallbackImplementation>(encoding, input_domain_size, output_domain_size, block_size, estimate_entropy);
+}
@@ -0,0 +1,28 @@
+#ifndef STORED_FALLBACK_H
+#define STORED_FALLBACK_H
+
+#include "encoding/encoding.h"
+#include "util.h"
+#include <memory>
+
+
+namespace encoding
+{
+    constexpr u64 DEFAULT_STORED_BLOCK_SIZE = 64 * 1024;
+
+    std::shared_ptr<EncodingImplementation> create_stored_fallback_implementation(std::shared_ptr<EncodingImplementation> encoding, u64 input_domain_size, u64 output_domain_size, u64 block_size, bool estimate_entropy);
+
+    // Encodes the input in independent blocks of block_size data. Blocks that the encoding would not shrink are
+    // stored instead, so incompressible data costs little more than a copy, both in time and in size.
+    // With estimate_entropy, blocks whose order 0 entropy leaves no room for savings are stored without trying
+    // the encoding at all; this should be turned off for encodings that exploit context, such as lz77
+    template<u64 IN, u64 OUT>
+    Encoding<IN, OUT> stored_fallback(const Encoding<IN, OUT>& encoding, u64 block_size = DEFAULT_STORED_BLOCK_SIZE, bool estimate_entropy = true)
+    {
+        static_assert(OUT >= 2, "Blocks need a flag");
+
+        return Encoding<IN, OUT>(create_stored_fallback_implementation(encoding.implementation(), IN, OUT, block_size, estimate_entropy));
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include "encoding/worker-pool.h"
+#include <assert.h>
+
+
+encoding::WorkerPool::WorkerPool(unsigned thread_count) : m_job(nullptr), m_generation(0), m_busy(0), m_stopping(false)
+{
+    assert(thread_count > 0);
+
+    for (unsigned worker = 1; worker < thread_count; ++worker)
+    {
+        m_threads.emplace_back([this, worker]() { serve(worker); });
+    }
+}
+
+encoding::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_started.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void encoding::WorkerPool::run(const std::function<void(unsigned)>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        assert(m_job == nullptr);
+
+        m_job = &job;
+        m_busy = unsigned(m_threads.size());
+        ++m_generation;
+    }
+
+    m_started.notify_all();
+    job(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+void encoding::WorkerPool::serve(unsigned worker)
+{
+    u64 generation = 0;
+
+    while (true)
+    {
+        const std::function<void(unsigned)>* job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_started.wait(lock, [&]() { return m_stopping || m_generation != generation; });
+
+            if (m_stopping)
+            {
+                return;
+            }
+
+            generation = m_generation;
+            job = m_job;
+        }
+
+        (*job)(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+        }
+
+        m_finished.notify_one();
+    }
+}
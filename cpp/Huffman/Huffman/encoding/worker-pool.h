@@ -0,0 +1,48 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "util.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace encoding
+{
+    // Threads that stay alive from one job to the next, so that running a job does not create any.
+    // The calling thread takes part in every job as worker 0
+    class WorkerPool
+    {
+    private:
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_started;
+        std::condition_variable m_finished;
+        const std::function<void(unsigned)>* m_job;
+        u64 m_generation;
+        unsigned m_busy;
+        bool m_stopping;
+
+    public:
+        WorkerPool(unsigned thread_count);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator =(const WorkerPool&) = delete;
+
+        unsigned thread_count() const
+        {
+            return unsigned(m_threads.size()) + 1;
+        }
+
+        // Calls job(worker) once for every worker and returns when all calls have returned
+        void run(const std::function<void(unsigned)>& job);
+
+    private:
+        void serve(unsigned worker);
+    };
+}
+
+#endif
@@ -1,6 +1,21 @@
 #include "io/binary-io.h"
 
 
+namespace
+{
+    // Truncated input reads as zeros, so that callers need not check every read, but is reported to the stream
+    Datum next(io::InputStream& input)
+    {
+        if (input.end_reached())
+        {
+            input.fail();
+            return 0;
+        }
+
+        return input.read();
+    }
+}
+
 void io::write_bits(u64 value, unsigned nbits, io::OutputStream& output)
 {
     assert((value >> nbits) == 0);
@@ -18,10 +33,35 @@ u64 io::read_bits(unsigned nbits, io::InputStream& input)
 
     for (unsigned i = 0; i != nbits; ++i)
     {
-        auto bit = input.end_reached() ? 0 : input.read();
+        auto bit = next(input);
         assert(bit == 0 || bit == 1);
         result = (result << 1) | u64(bit);
     }
 
     return result;
 }
+
+void io::write_bytes(u64 value, unsigned nbytes, io::OutputStream& output)
+{
+    assert(nbytes == 8 || (value >> (8 * nbytes)) == 0);
+
+    for (unsigned i = 0; i != nbytes; ++i)
+    {
+        auto b = (value >> (8 * (nbytes - i - 1))) & 0xFF;
+        output.write(b);
+    }
+}
+
+u64 io::read_bytes(unsigned nbytes, io::InputStream& input)
+{
+    u64 result = 0;
+
+    for (unsigned i = 0; i != nbytes; ++i)
+    {
+        auto b = next(input);
+        assert(b <= 0xFF);
+        result = (result << 8) | u64(b);
+    }
+
+    return result;
+}
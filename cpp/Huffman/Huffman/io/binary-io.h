@@ -8,6 +8,9 @@ namespace io
 {
     void write_bits(u64 value, unsigned nbits, io::OutputStream& output);
     u64 read_bits(unsigned nbits, io::InputStream& input);
+
+    void write_bytes(u64 value, unsigned nbytes, io::OutputStream& output);
+    u64 read_bytes(unsigned nbytes, io::InputStream& input);
 }
 
 #endif
@@ -63,7 +63,7 @@ namespace io
             return m_implementation.get();
         }
 
-        const DataSourceImplementation* operator->() const
+        const DataDestinationImplementation* operator->() const
         {
             return m_implementation.get();
         }
@@ -1,6 +1,6 @@
 #include "io/files.h"
 #include "io/streams.h"
-#include "io/memory-buffer.h"
+#include "io/memory-mapped-file.h"
 #include <assert.h>
 #include <fstream>
 #include <iostream>
@@ -30,6 +30,59 @@ namespace
         }
     };
 
+    // Reads straight from the mapped file, so rewinding is free and nothing is copied
+    class MappedFileInputStream : public io::InputStream
+    {
+    private:
+        io::MemoryMappedFile m_file;
+        size_t m_index;
+        size_t m_mark;
+        bool m_failed;
+
+    public:
+        MappedFileInputStream(const std::string& path) : m_file(path), m_index(0), m_mark(0), m_failed(false)
+        {
+            assert(m_file.is_open());
+        }
+
+        Datum read() override
+        {
+            assert(m_index < m_file.size());
+
+            return m_file.data()[m_index++];
+        }
+
+        bool end_reached() const override
+        {
+            return m_index == m_file.size();
+        }
+
+        bool rewindable() const override
+        {
+            return true;
+        }
+
+        void mark() override
+        {
+            m_mark = m_index;
+        }
+
+        void rewind() override
+        {
+            m_index = m_mark;
+        }
+
+        void fail() override
+        {
+            m_failed = true;
+        }
+
+        bool failed() const override
+        {
+            return m_failed;
+        }
+    };
+
     class FileDataSourceImplementation : public io::DataSourceImplementation
     {
     private:
@@ -61,16 +114,7 @@ namespace
 
 std::unique_ptr<io::InputStream> io::create_file_input_stream(const std::string& path)
 {
-    std::ifstream file(path, std::ios::binary);
-    file.seekg(0, std::ios::end);
-    auto size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    auto data = std::make_shared<std::vector<uint8_t>>(size);
-    file.read(reinterpret_cast<char*>(data->data()), size);
-
-    io::MemoryBuffer<256, uint8_t> memory(data);
-    return memory.source()->create_input_stream();
+    return std::make_unique<MappedFileInputStream>(path);
 }
 
 std::unique_ptr<io::OutputStream> io::create_file_output_stream(const std::string& path)
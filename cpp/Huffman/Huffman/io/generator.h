@@ -0,0 +1,173 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <coroutine>
+#include <cstdlib>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace io
+{
+    // Lazily computed sequence of values, produced by a coroutine that co_yields them.
+    // The coroutine only runs when the next value is requested, so chained generators
+    // process data in lockstep without buffering more than one value each
+    template<typename T>
+    class Generator
+    {
+    public:
+        struct promise_type
+        {
+            T current;
+
+            Generator get_return_object()
+            {
+                return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always yield_value(T value)
+            {
+                current = std::move(value);
+                return {};
+            }
+
+            void return_void()
+            {
+                // NOP
+            }
+
+            void unhandled_exception()
+            {
+                std::abort();
+            }
+        };
+
+        class iterator
+        {
+        private:
+            std::coroutine_handle<promise_type> m_handle;
+
+        public:
+            iterator(std::coroutine_handle<promise_type> handle) : m_handle(handle)
+            {
+                // NOP
+            }
+
+            const T& operator *() const
+            {
+                return m_handle.promise().current;
+            }
+
+            iterator& operator ++()
+            {
+                m_handle.resume();
+                return *this;
+            }
+
+            bool operator ==(std::default_sentinel_t) const
+            {
+                return m_handle.done();
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+
+        Generator(std::coroutine_handle<promise_type> handle) : m_handle(handle)
+        {
+            // NOP
+        }
+
+    public:
+        Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr))
+        {
+            // NOP
+        }
+
+        Generator& operator =(Generator&& other) noexcept
+        {
+            std::swap(m_handle, other.m_handle);
+            return *this;
+        }
+
+        Generator(const Generator&) = delete;
+        Generator& operator =(const Generator&) = delete;
+
+        ~Generator()
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+        }
+
+        // Can only be iterated over once
+        iterator begin()
+        {
+            assert(m_handle);
+
+            m_handle.resume();
+            return iterator(m_handle);
+        }
+
+        std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+    };
+
+    // Batches refer to the generator's internal buffer and are only valid until the next one is requested
+    typedef Generator<std::span<const Datum>> BatchGenerator;
+
+    // input must outlive the generator
+    inline BatchGenerator read_batches(InputStream& input, size_t batch_size)
+    {
+        assert(batch_size > 0);
+
+        std::vector<Datum> batch;
+        batch.reserve(batch_size);
+
+        while (!input.end_reached())
+        {
+            batch.push_back(input.read());
+
+            if (batch.size() == batch_size)
+            {
+                co_yield std::span<const Datum>(batch);
+                batch.clear();
+            }
+        }
+
+        if (!batch.empty())
+        {
+            co_yield std::span<const Datum>(batch);
+        }
+    }
+
+    inline void write_batches(BatchGenerator batches, OutputStream& output)
+    {
+        for (auto batch : batches)
+        {
+            for (auto datum : batch)
+            {
+                output.write(datum);
+            }
+        }
+    }
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define IO_UTIL_H
 
 #include "io/streams.h"
+#include <assert.h>
+#include <limits>
 #include <vector>
 
 
@@ -16,6 +18,23 @@ namespace io
         }
     }
 
+    // Reads the remainder of the input into a vector of T, which must be able to hold every datum
+    template<typename T>
+    std::vector<T> read_all(io::InputStream& input)
+    {
+        std::vector<T> result;
+
+        while (!input.end_reached())
+        {
+            auto datum = input.read();
+            assert(datum <= std::numeric_limits<T>::max());
+
+            result.push_back(static_cast<T>(datum));
+        }
+
+        return result;
+    }
+
     void transfer(io::InputStream& input, io::OutputStream& output);
     void transfer(io::InputStream& input, io::OutputStream& output, unsigned count);
 }
@@ -16,9 +16,11 @@ namespace io
     private:
         std::shared_ptr<const std::vector<T>> m_contents;
         size_t m_index;
+        size_t m_mark;
+        bool m_failed;
 
     public:
-        MemoryInputStream(std::shared_ptr<const std::vector<T>> contents) : m_contents(contents), m_index(0)
+        MemoryInputStream(std::shared_ptr<const std::vector<T>> contents) : m_contents(contents), m_index(0), m_mark(0), m_failed(false)
         {
             // NOP
         }
@@ -34,6 +36,31 @@ namespace io
         {
             return m_index == m_contents->size();
         }
+
+        bool rewindable() const override
+        {
+            return true;
+        }
+
+        void mark() override
+        {
+            m_mark = m_index;
+        }
+
+        void rewind() override
+        {
+            m_index = m_mark;
+        }
+
+        void fail() override
+        {
+            m_failed = true;
+        }
+
+        bool failed() const override
+        {
+            return m_failed;
+        }
     };
 
     template<typename T>
@@ -0,0 +1,107 @@
+#include "io/memory-mapped-file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+io::MemoryMappedFile::MemoryMappedFile(const std::string& path) : m_data(nullptr), m_size(0), m_handle(nullptr), m_open(false)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER size;
+
+    if (GetFileSizeEx(file, &size))
+    {
+        if (size.QuadPart == 0)
+        {
+            m_open = true;
+        }
+        else
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+            if (mapping != nullptr)
+            {
+                m_data = static_cast<const byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                m_size = m_data != nullptr ? size_t(size.QuadPart) : 0;
+                m_handle = mapping;
+                m_open = m_data != nullptr;
+            }
+        }
+    }
+
+    CloseHandle(file);
+}
+
+io::MemoryMappedFile::~MemoryMappedFile()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_handle != nullptr)
+    {
+        CloseHandle(m_handle);
+    }
+}
+
+#else
+
+io::MemoryMappedFile::MemoryMappedFile(const std::string& path) : m_data(nullptr), m_size(0), m_handle(nullptr), m_open(false)
+{
+    int file = open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat status;
+
+    if (fstat(file, &status) == 0)
+    {
+        if (status.st_size == 0)
+        {
+            m_open = true;
+        }
+        else
+        {
+            void* address = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (address != MAP_FAILED)
+            {
+                m_data = static_cast<const byte*>(address);
+                m_size = size_t(status.st_size);
+                m_open = true;
+            }
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(file);
+}
+
+io::MemoryMappedFile::~MemoryMappedFile()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<byte*>(m_data), m_size);
+    }
+}
+
+#endif
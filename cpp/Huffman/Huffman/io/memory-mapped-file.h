@@ -0,0 +1,45 @@
+#ifndef MEMORY_MAPPED_FILE_H
+#define MEMORY_MAPPED_FILE_H
+
+#include "util.h"
+#include <string>
+
+
+namespace io
+{
+    // Maps a whole file read-only into memory. Pages are only loaded when touched
+    // and are shared between all processes that map the same file. Empty files cannot be mapped:
+    // they are open, but have no data
+    class MemoryMappedFile
+    {
+    private:
+        const byte* m_data;
+        size_t m_size;
+        void* m_handle;
+        bool m_open;
+
+    public:
+        MemoryMappedFile(const std::string& path);
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator =(const MemoryMappedFile&) = delete;
+
+        bool is_open() const
+        {
+            return m_open;
+        }
+
+        const byte* data() const
+        {
+            return m_data;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+    };
+}
+
+#endif
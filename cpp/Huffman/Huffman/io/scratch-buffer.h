@@ -0,0 +1,74 @@
+#ifndef SCRATCH_BUFFER_H
+#define SCRATCH_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace io
+{
+    // Temporary vector borrowed from a per-thread pool and returned (emptied, but with its capacity intact)
+    // on destruction. Saves reallocating intermediate buffers for every message.
+    // A single large message must not pin its memory for the lifetime of the thread, so buffers
+    // above MAX_RETAINED_BYTES, and buffers beyond MAX_POOL_SIZE, are released instead
+    template<typename T>
+    class ScratchBuffer
+    {
+    public:
+        static constexpr size_t MAX_RETAINED_BYTES = size_t(1) << 20;
+        static constexpr size_t MAX_POOL_SIZE = 8;
+
+    private:
+        std::unique_ptr<std::vector<T>> m_buffer;
+
+        static std::vector<std::unique_ptr<std::vector<T>>>& pool()
+        {
+            thread_local std::vector<std::unique_ptr<std::vector<T>>> buffers;
+
+            return buffers;
+        }
+
+    public:
+        ScratchBuffer()
+        {
+            auto& buffers = pool();
+
+            if (buffers.empty())
+            {
+                m_buffer = std::make_unique<std::vector<T>>();
+            }
+            else
+            {
+                m_buffer = std::move(buffers.back());
+                buffers.pop_back();
+            }
+        }
+
+        ~ScratchBuffer()
+        {
+            auto& buffers = pool();
+
+            if (m_buffer->capacity() * sizeof(T) <= MAX_RETAINED_BYTES && buffers.size() < MAX_POOL_SIZE)
+            {
+                m_buffer->clear();
+                buffers.push_back(std::move(m_buffer));
+            }
+        }
+
+        ScratchBuffer(const ScratchBuffer&) = delete;
+        ScratchBuffer& operator =(const ScratchBuffer&) = delete;
+
+        std::vector<T>& operator *()
+        {
+            return *m_buffer;
+        }
+
+        std::vector<T>* operator ->()
+        {
+            return m_buffer.get();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef SPAN_STREAMS_H
+#define SPAN_STREAMS_H
+
+#include "io/streams.h"
+#include "util.h"
+#include <assert.h>
+#include <limits>
+#include <span>
+#include <vector>
+
+
+namespace io
+{
+    // Lightweight counterparts of MemoryInputStream and MemoryOutputStream: they refer to
+    // memory owned by someone else and can be retargeted, so that one stream object can serve many messages
+
+    template<typename T>
+    class SpanInputStream : public InputStream
+    {
+    private:
+        std::span<const T> m_contents;
+        size_t m_index;
+        size_t m_mark;
+        bool m_failed;
+
+    public:
+        SpanInputStream(std::span<const T> contents = std::span<const T>()) : m_contents(contents), m_index(0), m_mark(0), m_failed(false)
+        {
+            // NOP
+        }
+
+        void reset(std::span<const T> contents)
+        {
+            m_contents = contents;
+            m_index = 0;
+            m_mark = 0;
+            m_failed = false;
+        }
+
+        // Reading past the end (e.g. while decoding corrupt data) yields zeros and counts as a failure
+        Datum read() override
+        {
+            if (m_index == m_contents.size())
+            {
+                m_failed = true;
+                return 0;
+            }
+
+            return m_contents[m_index++];
+        }
+
+        bool end_reached() const override
+        {
+            return m_index == m_contents.size();
+        }
+
+        bool rewindable() const override
+        {
+            return true;
+        }
+
+        void mark() override
+        {
+            m_mark = m_index;
+        }
+
+        void rewind() override
+        {
+            m_index = m_mark;
+        }
+
+        void fail() override
+        {
+            m_failed = true;
+        }
+
+        bool failed() const override
+        {
+            return m_failed;
+        }
+    };
+
+    // Writes into caller provided memory. Data that do not fit are dropped and reported by overflowed()
+    template<typename T>
+    class SpanOutputStream : public OutputStream
+    {
+    private:
+        std::span<T> m_contents;
+        size_t m_size;
+        bool m_overflowed;
+
+    public:
+        SpanOutputStream(std::span<T> contents) : m_contents(contents), m_size(0), m_overflowed(false)
+        {
+            // NOP
+        }
+
+        void write(Datum value) override
+        {
+            assert(value <= std::numeric_limits<T>::max());
+
+            if (m_size == m_contents.size())
+            {
+                m_overflowed = true;
+                return;
+            }
+
+            m_contents[m_size++] = static_cast<T>(value);
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool overflowed() const override
+        {
+            return m_overflowed;
+        }
+    };
+
+    template<typename T>
+    class VectorOutputStream : public OutputStream
+    {
+    private:
+        std::vector<T>* m_contents;
+
+    public:
+        VectorOutputStream(std::vector<T>& contents) : m_contents(&contents)
+        {
+            // NOP
+        }
+
+        void reset(std::vector<T>& contents)
+        {
+            m_contents = &contents;
+        }
+
+        void write(Datum value) override
+        {
+            assert(value <= std::numeric_limits<T>::max());
+
+            m_contents->push_back(static_cast<T>(value));
+        }
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define INPUT_STREAM_H
 
 #include "util.h"
+#include <assert.h>
 
 
 namespace io
@@ -12,6 +13,17 @@ namespace io
 
         virtual Datum read()              = 0;
         virtual bool  end_reached() const = 0;
+
+        // Streams over data that is still available after reading (memory, files) can be rewound
+        // to the position recorded by mark(), so that encodings needing two passes do not have to keep a copy
+        virtual bool rewindable() const  { return false; }
+        virtual void mark()              { assert(false); }
+        virtual void rewind()            { assert(false); }
+
+        // Decoders call fail() when they find their input truncated or corrupt, so that whoever handed them
+        // the stream can tell; streams that have nowhere to keep this ignore it
+        virtual void fail()              { }
+        virtual bool failed() const      { return false; }
     };
 
     struct OutputStream
@@ -19,6 +31,10 @@ namespace io
         virtual ~OutputStream()         { }
 
         virtual void write(Datum value) = 0;
+
+        // Streams into bounded memory drop what does not fit; decoders whose output is not bounded
+        // by their input can check this to stop early
+        virtual bool overflowed() const { return false; }
     };
 }
 
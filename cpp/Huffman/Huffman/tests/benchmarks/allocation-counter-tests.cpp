@@ -0,0 +1,35 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "benchmarks/allocation-counter.h"
+#include "benchmarks/benchmark.h"
+#include <memory>
+
+
+TEST_CASE("Allocations per MB scale the count to a megabyte of input")
+{
+    REQUIRE(benchmarks::per_mb(0, 1024) == Approx(0));
+    REQUIRE(benchmarks::per_mb(1, 1024 * 1024) == Approx(1));
+    REQUIRE(benchmarks::per_mb(3, 512 * 1024) == Approx(6));
+    REQUIRE(benchmarks::per_mb(5, 0) == Approx(0));
+}
+
+TEST_CASE("Allocation counts never decrease")
+{
+    auto before = benchmarks::allocation_counts();
+    auto data = std::make_unique<u64[]>(1000);
+    data[0] = 1;
+    auto after = benchmarks::allocation_counts();
+
+    REQUIRE(after.count >= before.count);
+    REQUIRE(after.bytes >= before.bytes);
+
+    if (benchmarks::ALLOCATIONS_COUNTED)
+    {
+        REQUIRE(after.count > before.count);
+        REQUIRE(after.bytes >= before.bytes + 1000 * sizeof(u64));
+    }
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "benchmarks/corpora.h"
+#include "benchmarks/benchmark.h"
+#include "encoding/encodings.h"
+#include <array>
+
+
+TEST_CASE("Corpora have the requested size")
+{
+    for (size_t size : { 0, 1, 100, 10000 })
+    {
+        for (auto& corpus : benchmarks::standard_corpora(size, 1))
+        {
+            REQUIRE(corpus.data.size() == size);
+        }
+    }
+}
+
+TEST_CASE("Corpora are deterministic")
+{
+    auto first = benchmarks::standard_corpora(5000, 7);
+    auto second = benchmarks::standard_corpora(5000, 7);
+    auto other = benchmarks::standard_corpora(5000, 8);
+
+    for (size_t i = 0; i != first.size(); ++i)
+    {
+        REQUIRE(first[i].data == second[i].data);
+        REQUIRE(first[i].data != other[i].data);
+    }
+}
+
+TEST_CASE("Zipf corpus favors small bytes")
+{
+    std::array<u64, 256> counts { };
+
+    for (auto datum : benchmarks::zipf_corpus(100000, 1))
+    {
+        ++counts[datum];
+    }
+
+    REQUIRE(counts[0] > counts[1]);
+    REQUIRE(counts[1] > counts[10]);
+    REQUIRE(counts[10] > counts[200]);
+}
+
+TEST_CASE("Markov text corpus only contains characters of the training text")
+{
+    for (auto datum : benchmarks::markov_text_corpus(10000, 1))
+    {
+        REQUIRE((datum == '\n' || (datum >= 32 && datum < 127)));
+    }
+}
+
+TEST_CASE("Measuring an encoding")
+{
+    auto corpus = benchmarks::NamedCorpus{ "runs", benchmarks::runs_corpus(1000, 1) };
+    auto result = benchmarks::measure("huffman", encoding::huffman_encoding<256>(), corpus, 2);
+
+    REQUIRE(result.verified);
+    REQUIRE(result.input_size == 1000);
+    REQUIRE(result.ratio > 0);
+    REQUIRE(result.ratio < 1);
+    REQUIRE(result.encode_mb_per_second > 0);
+    REQUIRE(benchmarks::to_json({ result }).find("\"encoding\":\"huffman\"") != std::string::npos);
+}
+
+#endif
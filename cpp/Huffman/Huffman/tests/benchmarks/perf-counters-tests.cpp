@@ -0,0 +1,60 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "benchmarks/benchmark.h"
+#include "benchmarks/perf-counters.h"
+
+
+TEST_CASE("Performance counters can be read whether or not they are available")
+{
+    benchmarks::PerfCounters counters;
+    u64 sum = 0;
+
+    counters.start();
+
+    for (u64 i = 0; i != 100000; ++i)
+    {
+        sum += i * i;
+    }
+
+    auto values = counters.stop();
+
+    REQUIRE(sum > 0);
+
+    for (size_t i = 0; i != benchmarks::COUNTER_COUNT; ++i)
+    {
+        REQUIRE(values.values[i] >= 0);
+
+        if (!values.available[i])
+        {
+            REQUIRE(values.values[i] == 0);
+        }
+    }
+
+    if (values.available[size_t(benchmarks::Counter::INSTRUCTIONS)])
+    {
+        REQUIRE(values[benchmarks::Counter::INSTRUCTIONS] > 100000);
+    }
+}
+
+TEST_CASE("Counter values are normalized per byte")
+{
+    auto x = benchmarks::no_counters();
+    auto y = benchmarks::no_counters();
+
+    x.values.fill(10);
+    x.available.fill(true);
+    y.values.fill(30);
+    y.available.fill(true);
+    y.available[size_t(benchmarks::Counter::DTLB_MISSES)] = false;
+
+    auto sum = benchmarks::per_byte(benchmarks::add(x, y), 8);
+
+    REQUIRE(sum[benchmarks::Counter::CYCLES] == 5);
+    REQUIRE(sum.available[size_t(benchmarks::Counter::CYCLES)]);
+    REQUIRE(!sum.available[size_t(benchmarks::Counter::DTLB_MISSES)]);
+    REQUIRE(std::string(benchmarks::counter_name(benchmarks::Counter::LLC_MISSES)) == "llc_misses");
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifdef TEST_BUILD
+
+#pragma warning(disable : 26444)
+
+#include "catch.hpp"
+#include "data/arena-trie.h"
+
+
+namespace
+{
+    typedef data::ArenaTrie<char, int> trie;
+}
+
+
+TEST_CASE("Arena trie root data")
+{
+    trie t(16);
+
+    REQUIRE(t.size() == 1);
+    REQUIRE(t.data(trie::root) == 0);
+    REQUIRE(!t.has_children(trie::root));
+}
+
+TEST_CASE("Arena trie child creation")
+{
+    trie t(16);
+    auto a = t.child(trie::root, 'a');
+    auto b = t.child(a, 'b');
+
+    REQUIRE(a != trie::none);
+    REQUIRE(b != trie::none);
+    REQUIRE(a != b);
+    REQUIRE(t.size() == 3);
+    REQUIRE(t.child(trie::root, 'a') == a);
+    REQUIRE(t.find(a, 'b') == b);
+    REQUIRE(t.find(b, 'a') == trie::none);
+    REQUIRE(t.size() == 3);
+}
+
+TEST_CASE("Arena trie children of different parents are distinct")
+{
+    trie t(16);
+    auto a = t.child(trie::root, 'a');
+    auto aa = t.child(a, 'a');
+
+    t.data(a) = 1;
+    t.data(aa) = 2;
+
+    REQUIRE(t.data(t.find(trie::root, 'a')) == 1);
+    REQUIRE(t.data(t.find(a, 'a')) == 2);
+}
+
+TEST_CASE("Arena trie refuses to grow beyond capacity")
+{
+    trie t(3);
+    t.child(trie::root, 'a');
+    t.child(trie::root, 'b');
+
+    REQUIRE(t.child(trie::root, 'c') == trie::none);
+    REQUIRE(t.child(trie::root, 'b') != trie::none);
+}
+
+TEST_CASE("Arena trie clear")
+{
+    trie t(3);
+    t.child(trie::root, 'a');
+    t.child(trie::root, 'b');
+    t.clear();
+
+    REQUIRE(t.size() == 1);
+    REQUIRE(t.find(trie::root, 'a') == trie::none);
+    REQUIRE(t.child(trie::root, 'c') != trie::none);
+}
+
+TEST_CASE("Arena trie maximum key")
+{
+    trie t(16);
+    auto c = t.child(trie::root, 'c');
+    auto b = t.child(trie::root, 'b');
+
+    t.data(c)++;
+    t.update_maximum(trie::root, c, 'c');
+    REQUIRE(t.maximum_key(trie::root) == 'c');
+
+    t.data(b)++;
+    t.update_maximum(trie::root, b, 'b');
+    REQUIRE(t.maximum_key(trie::root) == 'b');
+
+    t.data(c)++;
+    t.update_maximum(trie::root, c, 'c');
+    REQUIRE(t.maximum_key(trie::root) == 'c');
+}
+
+TEST_CASE("Arena trie capacity for budget")
+{
+    auto capacity = trie::capacity_for_budget(1 << 20);
+
+    REQUIRE(capacity > 0);
+    REQUIRE(capacity < (1 << 20));
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "data/binary-tree.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    std::unique_ptr<data::Node<Datum>> L(Datum datum)
+    {
+        return std::make_unique<data::Leaf<Datum>>(datum);
+    }
+
+    std::unique_ptr<data::Node<Datum>> B(std::unique_ptr<data::Node<Datum>> left, std::unique_ptr<data::Node<Datum>> right)
+    {
+        return std::make_unique<data::Branch<Datum>>(std::move(left), std::move(right));
+    }
+
+    // Every branch has a leaf as its left child
+    std::unique_ptr<data::Node<Datum>> create_skewed_tree(unsigned depth)
+    {
+        auto tree = L(depth);
+
+        for (unsigned i = depth; i-- > 0; )
+        {
+            tree = B(L(i), std::move(tree));
+        }
+
+        return tree;
+    }
+}
+
+TEST_CASE("Folding a single leaf")
+{
+    auto tree = L(5);
+
+    auto result = data::fold(*tree, [](const Datum& datum) { return datum * 2; }, [](Datum x, Datum y) { return x + y; });
+
+    REQUIRE(result == 10);
+}
+
+TEST_CASE("Folding combines children left to right")
+{
+    auto tree = B(B(L(1), L(2)), L(3));
+
+    auto result = data::fold(*tree,
+        [](const Datum& datum) { return std::to_string(datum); },
+        [](std::string left, std::string right) { return "(" + left + " " + right + ")"; });
+
+    REQUIRE(result == "((1 2) 3)");
+}
+
+TEST_CASE("Visiting leaves left to right")
+{
+    auto tree = B(B(L(1), B(L(2), L(3))), B(L(4), L(5)));
+    std::vector<Datum> leaves;
+
+    data::visit_leaves(*tree, [&](const Datum& datum) { leaves.push_back(datum); });
+
+    REQUIRE(leaves == std::vector<Datum>{ 1, 2, 3, 4, 5 });
+}
+
+TEST_CASE("Mapping a tree keeps its shape")
+{
+    auto tree = B(B(L(1), L(2)), L(3));
+
+    auto result = data::map<Datum, Datum>(*tree, [](const Datum& datum) { return datum + 1; });
+
+    REQUIRE(result->equal_to(*B(B(L(2), L(3)), L(4))));
+}
+
+TEST_CASE("Mapping a tree to another type")
+{
+    auto tree = B(L(1), L(2));
+
+    auto result = data::map<Datum, bool>(*tree, [](const Datum& datum) { return datum % 2 == 0; });
+    std::vector<bool> leaves;
+
+    data::visit_leaves(*result, [&](const bool& b) { leaves.push_back(b); });
+
+    REQUIRE(leaves == std::vector<bool>{ false, true });
+}
+
+TEST_CASE("Deep trees are built, traversed and destroyed without recursion")
+{
+    // Deep enough to overflow the call stack if any of these recursed
+    const unsigned depth = 1000000;
+
+    auto tree = create_skewed_tree(depth);
+
+    auto depth_of_tree = data::fold(*tree, [](const Datum&) { return u64(0); }, [](u64 x, u64 y) { return std::max(x, y) + 1; });
+    u64 sum = 0;
+    data::visit_leaves(*tree, [&](const Datum& datum) { sum += datum; });
+    auto copy = data::map<Datum, Datum>(*tree, [](const Datum& datum) { return datum; });
+
+    REQUIRE(depth_of_tree == depth);
+    REQUIRE(sum == u64(depth) * (depth + 1) / 2);
+    REQUIRE(data::fold(*copy, [](const Datum&) { return u64(0); }, [](u64 x, u64 y) { return std::max(x, y) + 1; }) == depth);
+}
+
+#endif
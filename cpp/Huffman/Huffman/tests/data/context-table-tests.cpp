@@ -0,0 +1,123 @@
+#ifdef TEST_BUILD
+
+#pragma warning(disable : 26444)
+
+#include "catch.hpp"
+#include "data/context-table.h"
+
+
+TEST_CASE("Context table is initially empty")
+{
+    data::ContextTable table(4);
+    Datum prediction;
+    unsigned confidence;
+
+    REQUIRE(table.size() == 16);
+    REQUIRE(!table.lookup(123, &prediction, &confidence));
+}
+
+TEST_CASE("Context table remembers last datum")
+{
+    data::ContextTable table(4);
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(123, 7);
+
+    REQUIRE(table.lookup(123, &prediction, &confidence));
+    REQUIRE(prediction == 7);
+    REQUIRE(confidence == 1);
+}
+
+TEST_CASE("Context table confidence grows with correct predictions")
+{
+    data::ContextTable table(4);
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(5, 7);
+    table.update(5, 7);
+    table.update(5, 7);
+    table.update(5, 8);
+
+    REQUIRE(table.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 7);
+    REQUIRE(confidence == 2);
+}
+
+TEST_CASE("Context table replaces prediction when confidence runs out")
+{
+    data::ContextTable table(4);
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(5, 7);
+    table.update(5, 8);
+
+    REQUIRE(table.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 8);
+}
+
+TEST_CASE("Context table clear")
+{
+    data::ContextTable table(4);
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(5, 7);
+    table.clear();
+
+    REQUIRE(!table.lookup(5, &prediction, &confidence));
+}
+
+TEST_CASE("Context table starts out with contents of base")
+{
+    data::ContextTable trained(4);
+    trained.update(5, 7);
+
+    data::ContextTable table(4, trained.slots());
+    Datum prediction;
+    unsigned confidence;
+
+    REQUIRE(table.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 7);
+}
+
+TEST_CASE("Context table leaves base untouched")
+{
+    data::ContextTable trained(4);
+    trained.update(5, 7);
+
+    data::ContextTable table(4, trained.slots());
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(5, 8);
+    table.update(6, 9);
+
+    REQUIRE(table.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 8);
+    REQUIRE(trained.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 7);
+    REQUIRE(!trained.lookup(6, &prediction, &confidence));
+}
+
+TEST_CASE("Context table clear restores base")
+{
+    data::ContextTable trained(4);
+    trained.update(5, 7);
+
+    data::ContextTable table(4, trained.slots());
+    Datum prediction;
+    unsigned confidence;
+
+    table.update(5, 8);
+    table.update(6, 9);
+    table.clear();
+
+    REQUIRE(table.lookup(5, &prediction, &confidence));
+    REQUIRE(prediction == 7);
+    REQUIRE(!table.lookup(6, &prediction, &confidence));
+}
+
+#endif
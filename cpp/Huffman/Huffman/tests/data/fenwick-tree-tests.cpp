@@ -0,0 +1,79 @@
+#ifdef TEST_BUILD
+
+#pragma warning(disable : 26444)
+
+#include "catch.hpp"
+#include "data/fenwick-tree.h"
+
+
+TEST_CASE("Empty Fenwick tree")
+{
+    data::FenwickTree tree(10);
+
+    REQUIRE(tree.total() == 0);
+    REQUIRE(tree[0] == 0);
+    REQUIRE(tree.cumulative(10) == 0);
+}
+
+TEST_CASE("Fenwick tree frequencies")
+{
+    data::FenwickTree tree(10);
+    tree.increment(3);
+    tree.add(5, 4);
+    tree.increment(3);
+
+    REQUIRE(tree.total() == 6);
+    REQUIRE(tree[3] == 2);
+    REQUIRE(tree[5] == 4);
+    REQUIRE(tree[4] == 0);
+}
+
+TEST_CASE("Fenwick tree cumulative frequencies")
+{
+    data::FenwickTree tree(7);
+
+    for (u64 i = 0; i != 7; ++i)
+    {
+        tree.add(i, i + 1);
+    }
+
+    for (u64 i = 0; i <= 7; ++i)
+    {
+        REQUIRE(tree.cumulative(i) == i * (i + 1) / 2);
+    }
+}
+
+TEST_CASE("Fenwick tree find")
+{
+    data::FenwickTree tree(7);
+
+    for (u64 i = 0; i != 7; ++i)
+    {
+        tree.add(i, i % 3);
+    }
+
+    for (u64 target = 0; target != tree.total(); ++target)
+    {
+        auto value = tree.find(target);
+
+        REQUIRE(tree.cumulative(value) <= target);
+        REQUIRE(target < tree.cumulative(value + 1));
+    }
+}
+
+TEST_CASE("Fenwick tree halving")
+{
+    data::FenwickTree tree(4);
+    tree.add(0, 1);
+    tree.add(1, 8);
+    tree.add(3, 5);
+    tree.halve();
+
+    REQUIRE(tree[0] == 1);
+    REQUIRE(tree[1] == 4);
+    REQUIRE(tree[2] == 0);
+    REQUIRE(tree[3] == 3);
+    REQUIRE(tree.total() == 8);
+}
+
+#endif
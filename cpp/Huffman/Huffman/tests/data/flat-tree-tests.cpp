@@ -0,0 +1,184 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "data/flat-tree.h"
+#include "data/frequency-table.h"
+#include "encoding/huffman/tree-building.h"
+#include "encoding/huffman/tree-encoding.h"
+#include "encoding/huffman/code-building.h"
+#include "encoding/huffman/decoding.h"
+#include "io/memory-buffer.h"
+#include "io/io-util.h"
+#include <vector>
+
+
+namespace
+{
+    data::FrequencyTable<Datum> create_frequencies(const std::vector<Datum>& data)
+    {
+        data::FrequencyTable<Datum> frequencies;
+
+        for (auto datum : data)
+        {
+            frequencies.increment(datum);
+        }
+
+        return frequencies;
+    }
+
+    const std::vector<Datum> SAMPLE{ 0, 1, 1, 2, 2, 2, 3, 3, 3, 3, 4, 5, 5, 6, 7, 7, 7, 7, 7, 7, 12, 15, 15 };
+}
+
+TEST_CASE("Flat tree leaves are negative")
+{
+    REQUIRE(data::FlatTree::is_leaf(data::FlatTree::leaf(0)));
+    REQUIRE(data::FlatTree::is_leaf(data::FlatTree::leaf(1000)));
+    REQUIRE(data::FlatTree::datum(data::FlatTree::leaf(0)) == 0);
+    REQUIRE(data::FlatTree::datum(data::FlatTree::leaf(1000)) == 1000);
+}
+
+TEST_CASE("Flat tree built by hand")
+{
+    data::FlatTree tree;
+
+    auto inner = tree.branch(data::FlatTree::leaf(0), data::FlatTree::leaf(1));
+    tree.set_root(tree.branch(inner, data::FlatTree::leaf(2)));
+
+    REQUIRE(tree.branch_count() == 2);
+    REQUIRE(tree.child(tree.root(), 1) == data::FlatTree::leaf(2));
+    REQUIRE(tree.child(tree.child(tree.root(), 0), 1) == data::FlatTree::leaf(1));
+
+    data::Branch<Datum> expected(
+        std::make_unique<data::Branch<Datum>>(std::make_unique<data::Leaf<Datum>>(0), std::make_unique<data::Leaf<Datum>>(1)),
+        std::make_unique<data::Leaf<Datum>>(2));
+
+    REQUIRE(tree.equal_to(data::FlatTree(expected)));
+}
+
+TEST_CASE("Flat trees with different shapes are not equal")
+{
+    data::FlatTree x;
+    data::FlatTree y;
+
+    x.set_root(x.branch(x.branch(data::FlatTree::leaf(0), data::FlatTree::leaf(1)), data::FlatTree::leaf(2)));
+    y.set_root(y.branch(data::FlatTree::leaf(0), y.branch(data::FlatTree::leaf(1), data::FlatTree::leaf(2))));
+
+    REQUIRE(!x.equal_to(y));
+    REQUIRE(x.equal_to(x));
+}
+
+TEST_CASE("Building a flat tree gives the same tree as building a pointer based one")
+{
+    auto frequencies = create_frequencies(SAMPLE);
+
+    auto expected = encoding::huffman::build_tree(frequencies);
+    auto actual = encoding::huffman::build_flat_tree(frequencies);
+
+    REQUIRE(actual.equal_to(data::FlatTree(*expected)));
+    REQUIRE(actual.branch_count() == 9);
+}
+
+TEST_CASE("Rebuilding a flat tree in place replaces the previous tree")
+{
+    data::FlatTree tree;
+
+    encoding::huffman::build_flat_tree(create_frequencies({ 0, 0, 1, 2, 3, 3, 3 }), tree);
+    encoding::huffman::build_flat_tree(create_frequencies(SAMPLE), tree);
+
+    REQUIRE(tree.equal_to(encoding::huffman::build_flat_tree(create_frequencies(SAMPLE))));
+    REQUIRE(tree.branch_count() == 9);
+}
+
+TEST_CASE("Codes of flat trees are those of pointer based trees")
+{
+    auto frequencies = create_frequencies(SAMPLE);
+
+    auto expected = encoding::huffman::build_codes(*encoding::huffman::build_tree(frequencies), 16);
+    auto actual = encoding::huffman::build_codes(encoding::huffman::build_flat_tree(frequencies), 16);
+
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("Finding the code of a single datum in a flat tree")
+{
+    auto tree = encoding::huffman::build_flat_tree(create_frequencies(SAMPLE));
+    auto codes = encoding::huffman::build_codes(tree, 16);
+    std::vector<Datum> code;
+
+    for (Datum datum = 0; datum != 16; ++datum)
+    {
+        REQUIRE(encoding::huffman::find_code(tree, datum, code) == !codes[datum].empty());
+        REQUIRE(code == codes[datum]);
+    }
+}
+
+TEST_CASE("Flat trees are encoded like pointer based trees")
+{
+    auto frequencies = create_frequencies(SAMPLE);
+
+    io::MemoryBuffer<2> expected;
+    io::MemoryBuffer<2> actual;
+
+    encoding::huffman::encode_tree(*encoding::huffman::build_tree(frequencies), 4, *expected.destination()->create_output_stream());
+    encoding::huffman::encode_tree(encoding::huffman::build_flat_tree(frequencies), 4, *actual.destination()->create_output_stream());
+
+    REQUIRE(*actual.data() == *expected.data());
+
+    auto decoded = encoding::huffman::decode_flat_tree(4, 16, *actual.source()->create_input_stream());
+
+    REQUIRE(decoded.equal_to(encoding::huffman::build_flat_tree(frequencies)));
+}
+
+TEST_CASE("Decoding with a flat tree")
+{
+    auto frequencies = create_frequencies(SAMPLE);
+    auto tree = encoding::huffman::build_flat_tree(frequencies);
+    auto codes = encoding::huffman::build_codes(tree, 16);
+
+    io::MemoryBuffer<2> bits;
+    io::MemoryBuffer<16, Datum> result;
+
+    {
+        auto output = bits.destination()->create_output_stream();
+
+        for (auto datum : SAMPLE)
+        {
+            io::transfer(codes[datum], *output);
+        }
+    }
+
+    encoding::huffman::decode_bits(*bits.source()->create_input_stream(), tree, *result.destination()->create_output_stream());
+
+    REQUIRE(*result.data() == SAMPLE);
+}
+
+TEST_CASE("Decoding a flat tree with too many branches fails")
+{
+    // Would be a tree as deep as the input is long
+    io::MemoryBuffer<2> bits(std::vector<uint8_t>(100000, 0));
+    auto input = bits.source()->create_input_stream();
+
+    auto decoded = encoding::huffman::decode_flat_tree(4, 16, *input);
+
+    REQUIRE(input->failed());
+    REQUIRE(data::FlatTree::is_leaf(decoded.root()));
+}
+
+TEST_CASE("Decoding a flat tree with a leaf outside the domain fails")
+{
+    data::FlatTree tree;
+    io::MemoryBuffer<2> bits;
+
+    tree.set_root(tree.branch(data::FlatTree::leaf(3), data::FlatTree::leaf(12)));
+    encoding::huffman::encode_tree(tree, 4, *bits.destination()->create_output_stream());
+
+    auto input = bits.source()->create_input_stream();
+    auto decoded = encoding::huffman::decode_flat_tree(4, 12, *input);
+
+    REQUIRE(input->failed());
+    REQUIRE(data::FlatTree::is_leaf(decoded.root()));
+    REQUIRE(encoding::huffman::decode_flat_tree(4, 13, *bits.source()->create_input_stream()).equal_to(tree));
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "catch.hpp"
 #include "data/trie.h"
 #include <algorithm>
+#include <string>
 
 
 TEST_CASE("Initialization of trie root data")
@@ -61,4 +62,53 @@ TEST_CASE("Enumerating keys (two)")
     REQUIRE(std::find(keys.begin(), keys.end(), 'b') != keys.end());
 }
 
+TEST_CASE("Maximum key (one child)")
+{
+    data::Trie<char, int> trie;
+    trie['a'].data++;
+    trie.update_maximum('a');
+
+    REQUIRE(trie.maximum_key() == 'a');
+}
+
+TEST_CASE("Maximum key follows largest data")
+{
+    data::Trie<char, int> trie;
+    trie['a'].data++;
+    trie.update_maximum('a');
+    trie['b'].data++;
+    trie.update_maximum('b');
+    trie['b'].data++;
+    trie.update_maximum('b');
+
+    REQUIRE(trie.maximum_key() == 'b');
+}
+
+TEST_CASE("Maximum key prefers smallest key on ties")
+{
+    data::Trie<char, int> trie;
+    trie['c'].data++;
+    trie.update_maximum('c');
+    trie['b'].data++;
+    trie.update_maximum('b');
+    trie['d'].data++;
+    trie.update_maximum('d');
+
+    REQUIRE(trie.maximum_key() == 'b');
+}
+
+TEST_CASE("Visiting children")
+{
+    data::Trie<char, int> trie;
+    trie['b'].data = 2;
+    trie['a'].data = 1;
+    std::string keys;
+    int sum = 0;
+
+    trie.for_each_child([&](char key, const data::Trie<char, int>& child) { keys += key; sum += child.data; });
+
+    REQUIRE(keys == "ab");
+    REQUIRE(sum == 3);
+}
+
 #endif
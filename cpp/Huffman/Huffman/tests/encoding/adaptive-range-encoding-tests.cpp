@@ -0,0 +1,85 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+#include <string>
+
+
+namespace
+{
+    template<u64 IN>
+    void check(const std::vector<Datum>& data)
+    {
+        auto encoding = encoding::adaptive_range_encoding<IN>();
+        io::MemoryBuffer<IN, Datum> buffer1(data);
+        io::MemoryBuffer<256> buffer2;
+        io::MemoryBuffer<IN> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        auto results = buffer3.data();
+
+        REQUIRE(data.size() == results->size());
+
+        for (size_t i = 0; i != data.size(); ++i)
+        {
+            REQUIRE(data[i] == (*results)[i]);
+        }
+    }
+
+    std::vector<Datum> text(size_t size)
+    {
+        const std::string sentence = "it was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness. ";
+        std::vector<Datum> result;
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            result.push_back(byte(sentence[i % sentence.size()]));
+        }
+
+        return result;
+    }
+}
+
+#define TESTN(N, ...) TEST_CASE("Adaptive Range Encoding (DS=" #N ") on { " #__VA_ARGS__ " }") { check<N>(std::vector<Datum> { __VA_ARGS__ }); }
+
+#define TEST4(...)   TESTN(4, __VA_ARGS__)
+#define TEST256(...) TESTN(256, __VA_ARGS__)
+
+TEST4()
+TEST4(0)
+TEST4(3)
+TEST4(0, 1, 2, 3)
+TEST256(0, 1)
+TEST256(255, 255, 255)
+TEST256(1, 2, 3, 2, 1)
+TEST256(1, 1, 2, 3, 3, 4, 4, 4, 4, 3, 2, 1, 2, 3, 4)
+
+
+TEST_CASE("Adaptive Range Encoding on long text")
+{
+    check<256>(text(20000));
+}
+
+TEST_CASE("Adaptive Range Encoding on long run")
+{
+    check<256>(std::vector<Datum>(50000, 7));
+}
+
+TEST_CASE("Adaptive Range Encoding compresses better than adaptive Huffman")
+{
+    auto data = text(5000);
+    io::MemoryBuffer<256, Datum> original(data);
+    io::MemoryBuffer<256> range_compressed;
+    io::MemoryBuffer<256> huffman_compressed;
+
+    encoding::encode(original.source(), encoding::adaptive_range_encoding<256>(), range_compressed.destination());
+    encoding::encode(original.source(), encoding::adaptive_huffman<256>() | encoding::bit_grouper<8>(), huffman_compressed.destination());
+
+    REQUIRE(range_compressed.data()->size() < huffman_compressed.data()->size());
+}
+
+#endif
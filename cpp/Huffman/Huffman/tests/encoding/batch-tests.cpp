@@ -0,0 +1,116 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/batch.h"
+#include "encoding/encodings.h"
+#include "encoding/predictive/oracles.h"
+#include "io/memory-buffer.h"
+#include <span>
+#include <vector>
+
+
+namespace
+{
+    auto create_pipeline()
+    {
+        return encoding::predictive_encoding<256>([]() { return encoding::predictive::trie_oracle(2); }) | encoding::eof_encoding<256>() | encoding::huffman_encoding<257>() | encoding::bit_grouper<8>();
+    }
+
+    std::vector<std::vector<uint8_t>> create_messages(size_t count)
+    {
+        std::vector<std::vector<uint8_t>> result;
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            std::vector<uint8_t> message;
+
+            for (size_t j = 0; j != 1 + i % 50; ++j)
+            {
+                message.push_back(uint8_t('a' + (i + j * j) % 7));
+            }
+
+            result.push_back(message);
+        }
+
+        return result;
+    }
+
+    std::vector<std::span<const uint8_t>> to_spans(const std::vector<std::vector<uint8_t>>& messages)
+    {
+        return std::vector<std::span<const uint8_t>>(messages.begin(), messages.end());
+    }
+
+    std::vector<uint8_t> encode_single(const std::vector<uint8_t>& message)
+    {
+        io::MemoryBuffer<256> original(message);
+        io::MemoryBuffer<256> encoded;
+
+        encoding::encode(original.source(), create_pipeline(), encoded.destination());
+
+        return *encoded.data();
+    }
+
+    void check_batch(unsigned thread_count, size_t message_count)
+    {
+        auto messages = create_messages(message_count);
+        auto batch = encoding::batch(create_pipeline(), thread_count);
+        auto& encoded = batch.encode(to_spans(messages));
+
+        REQUIRE(encoded.size() == messages.size());
+
+        for (size_t i = 0; i != messages.size(); ++i)
+        {
+            REQUIRE(std::vector<uint8_t>(encoded[i].begin(), encoded[i].end()) == encode_single(messages[i]));
+        }
+
+        auto& decoded = batch.decode(encoded);
+
+        REQUIRE(decoded.size() == messages.size());
+
+        for (size_t i = 0; i != messages.size(); ++i)
+        {
+            REQUIRE(std::vector<uint8_t>(decoded[i].begin(), decoded[i].end()) == messages[i]);
+        }
+    }
+}
+
+
+TEST_CASE("Batch encoding of no messages")
+{
+    check_batch(4, 0);
+}
+
+TEST_CASE("Batch encoding on a single thread")
+{
+    check_batch(1, 100);
+}
+
+TEST_CASE("Batch encoding on multiple threads")
+{
+    check_batch(4, 500);
+}
+
+TEST_CASE("Batch encoding with more threads than messages")
+{
+    check_batch(8, 3);
+}
+
+TEST_CASE("Batch encoder reused for several batches")
+{
+    auto batch = encoding::batch(create_pipeline(), 3);
+    auto messages1 = create_messages(200);
+    auto messages2 = create_messages(20);
+
+    batch.encode(to_spans(messages1));
+    auto& encoded = batch.encode(to_spans(messages2));
+
+    REQUIRE(encoded.size() == messages2.size());
+
+    for (size_t i = 0; i != messages2.size(); ++i)
+    {
+        REQUIRE(std::vector<uint8_t>(encoded[i].begin(), encoded[i].end()) == encode_single(messages2[i]));
+    }
+}
+
+#endif
@@ -0,0 +1,294 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/compression.h"
+#include "encoding/encodings.h"
+#include "encoding/fused/fused.h"
+#include "encoding/predictive/oracles.h"
+#include "io/memory-buffer.h"
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    template<u64 IN, u64 OUT>
+    void check_bound(encoding::Encoding<IN, OUT> encoding)
+    {
+        for (auto& sample : test_data::create_samples(IN))
+        {
+            io::MemoryBuffer<IN, Datum> original(sample);
+            io::MemoryBuffer<OUT, Datum> encoded;
+
+            encoding::encode(original.source(), encoding, encoded.destination());
+
+            REQUIRE(encoded.data()->size() <= encoding->max_encoded_size(sample.size()));
+        }
+    }
+
+    encoding::Encoding<256, 256> create_pipeline()
+    {
+        return encoding::eof_encoding<256>() | encoding::huffman_encoding<257>() | encoding::bit_grouper<8>();
+    }
+
+    std::vector<uint8_t> to_bytes(const std::string& string)
+    {
+        return std::vector<uint8_t>(string.begin(), string.end());
+    }
+
+    // Every truncation and every single bit flip of the compressed data must either fail or decompress
+    // to something that fits the buffer; truncations that succeed must give back the original
+    void check_corruption(const encoding::Encoding<256, 256>& encoding)
+    {
+        auto original = to_bytes("it was the best of times, it was the worst of times, it was the age of wisdom");
+        auto noise = test_data::pseudo_random(200, 12, 5);
+        original.insert(original.end(), noise.begin(), noise.end());
+
+        std::vector<uint8_t> compressed(encoding::max_compressed_size(encoding, original.size()));
+        std::vector<uint8_t> decompressed(original.size());
+
+        auto compressed_size = encoding::compress(encoding, original, compressed);
+        compressed.resize(compressed_size);
+
+        REQUIRE(encoding::decompress(encoding, compressed, decompressed) == original.size());
+
+        for (size_t size = 0; size != compressed_size; ++size)
+        {
+            auto result = encoding::decompress(encoding, std::span<const uint8_t>(compressed.data(), size), decompressed);
+
+            REQUIRE((result == encoding::COMPRESSION_FAILED || (result == original.size() && decompressed == original)));
+        }
+
+        for (size_t i = 0; i != compressed_size * 8; ++i)
+        {
+            auto corrupt = compressed;
+            corrupt[i / 8] ^= uint8_t(1 << (i % 8));
+
+            auto result = encoding::decompress(encoding, corrupt, decompressed);
+
+            REQUIRE((result == encoding::COMPRESSION_FAILED || result <= decompressed.size()));
+        }
+    }
+}
+
+
+TEST_CASE("Maximum encoded size of EOF encoding")
+{
+    check_bound(encoding::eof_encoding<256>());
+}
+
+TEST_CASE("Maximum encoded size of move to front")
+{
+    check_bound(encoding::move_to_front<256>());
+    check_bound(encoding::move_to_front_fast<256>());
+}
+
+TEST_CASE("Maximum encoded size of predictive encoding")
+{
+    check_bound(encoding::predictive_encoding<256>([]() { return encoding::predictive::trie_oracle(2); }));
+}
+
+TEST_CASE("Maximum encoded size of Huffman encoding")
+{
+    check_bound(encoding::huffman_encoding<4>());
+    check_bound(encoding::huffman_encoding<256>());
+}
+
+TEST_CASE("Maximum encoded size of adaptive Huffman encoding")
+{
+    check_bound(encoding::adaptive_huffman<4>());
+    check_bound(encoding::adaptive_huffman<256>());
+}
+
+TEST_CASE("Maximum encoded size of adaptive Huffman encoding holds for Fibonacci frequencies")
+{
+    auto data = test_data::fibonacci_frequencies(20);
+    auto encoding = encoding::adaptive_huffman<32>();
+    io::MemoryBuffer<32, Datum> original(data);
+    io::MemoryBuffer<2, Datum> encoded;
+
+    encoding::encode(original.source(), encoding, encoded.destination());
+
+    REQUIRE(encoded.data()->size() <= encoding->max_encoded_size(data.size()));
+    REQUIRE(encoding::adaptive_huffman<256>()->max_encoded_size(1000000) < 40 * 1000000);
+}
+
+TEST_CASE("Maximum encoded size of static Huffman encoding")
+{
+    REQUIRE(encoding::huffman::register_codebook(100, encoding::huffman::train_codebook(test_data::fibonacci_frequencies(12), 256)));
+
+    check_bound(encoding::static_huffman_encoding<256>(100));
+}
+
+TEST_CASE("Maximum encoded size of rANS encoding")
+{
+    check_bound(encoding::rans_encoding<256>());
+}
+
+TEST_CASE("Maximum encoded size of adaptive range encoding")
+{
+    check_bound(encoding::adaptive_range_encoding<256>());
+}
+
+TEST_CASE("Maximum encoded size of LZ77 encoding")
+{
+    check_bound(encoding::lz77<256>());
+    check_bound(encoding::lz77<2>(16));
+}
+
+TEST_CASE("Maximum encoded size of bit grouper")
+{
+    check_bound(encoding::bit_grouper<8>());
+    check_bound(encoding::bit_grouper<3>());
+}
+
+TEST_CASE("Maximum encoded size of combined encodings")
+{
+    check_bound(create_pipeline());
+    check_bound(encoding::lz77<256>() | encoding::adaptive_range_encoding<257>());
+}
+
+TEST_CASE("Compressing into caller provided buffer")
+{
+    auto pipeline = create_pipeline();
+    auto original = to_bytes("it was the best of times, it was the worst of times");
+    std::vector<uint8_t> compressed(encoding::max_compressed_size(pipeline, original.size()));
+    std::vector<uint8_t> decompressed(original.size());
+
+    auto compressed_size = encoding::compress(pipeline, original, compressed);
+    auto decompressed_size = encoding::decompress(pipeline, std::span<const uint8_t>(compressed.data(), compressed_size), decompressed);
+
+    REQUIRE(compressed_size < original.size());
+    REQUIRE(decompressed_size == original.size());
+    REQUIRE(decompressed == original);
+}
+
+TEST_CASE("Compressing and decompressing sizes that need several bytes")
+{
+    auto pipeline = create_pipeline();
+    std::vector<uint8_t> original(100000, 'a');
+    original[50000] = 'b';
+    std::vector<uint8_t> compressed(encoding::max_compressed_size(pipeline, original.size()));
+    std::vector<uint8_t> decompressed(original.size());
+
+    auto compressed_size = encoding::compress(pipeline, original, compressed);
+    auto decompressed_size = encoding::decompress(pipeline, std::span<const uint8_t>(compressed.data(), compressed_size), decompressed);
+
+    REQUIRE(decompressed_size == original.size());
+    REQUIRE(decompressed == original);
+}
+
+TEST_CASE("Compressing matches encode")
+{
+    auto pipeline = create_pipeline();
+    auto original = to_bytes("abracadabra");
+    std::vector<uint8_t> compressed(encoding::max_compressed_size(pipeline, original.size()));
+    io::MemoryBuffer<256> buffer1(original);
+    io::MemoryBuffer<256> buffer2;
+
+    auto compressed_size = encoding::compress(pipeline, original, compressed);
+    encoding::encode(buffer1.source(), pipeline, buffer2.destination());
+    compressed.resize(compressed_size);
+
+    // Compressed data start with the size, which fits in one byte here
+    REQUIRE(compressed[0] == original.size());
+    REQUIRE(std::vector<uint8_t>(compressed.begin() + 1, compressed.end()) == *buffer2.data());
+}
+
+TEST_CASE("Compressing into too small a buffer fails")
+{
+    auto pipeline = create_pipeline();
+    auto original = to_bytes("it was the best of times, it was the worst of times");
+    std::vector<uint8_t> compressed(10);
+
+    REQUIRE(encoding::compress(pipeline, original, compressed) == encoding::COMPRESSION_FAILED);
+}
+
+TEST_CASE("Decompressing into too small a buffer fails without writing")
+{
+    auto pipeline = create_pipeline();
+    auto original = to_bytes("it was the best of times, it was the worst of times");
+    std::vector<uint8_t> compressed(encoding::max_compressed_size(pipeline, original.size()));
+    std::vector<uint8_t> decompressed(original.size() - 1, 0);
+
+    auto compressed_size = encoding::compress(pipeline, original, compressed);
+    auto decompressed_size = encoding::decompress(pipeline, std::span<const uint8_t>(compressed.data(), compressed_size), decompressed);
+
+    REQUIRE(decompressed_size == encoding::COMPRESSION_FAILED);
+    REQUIRE(decompressed == std::vector<uint8_t>(original.size() - 1, 0));
+}
+
+TEST_CASE("Decompressing data that do not match their size fails")
+{
+    auto pipeline = create_pipeline();
+    auto original = to_bytes("it was the best of times, it was the worst of times");
+    std::vector<uint8_t> compressed(encoding::max_compressed_size(pipeline, original.size()));
+    std::vector<uint8_t> decompressed(original.size() + 10);
+
+    auto compressed_size = encoding::compress(pipeline, original, compressed);
+    ++compressed[0];
+
+    REQUIRE(encoding::decompress(pipeline, std::span<const uint8_t>(compressed.data(), compressed_size), decompressed) == encoding::COMPRESSION_FAILED);
+    REQUIRE(encoding::decompress(pipeline, std::span<const uint8_t>(compressed.data(), 3), decompressed) == encoding::COMPRESSION_FAILED);
+}
+
+TEST_CASE("Decompressing corrupt data with Huffman encoding")
+{
+    check_corruption(create_pipeline());
+}
+
+TEST_CASE("Decompressing corrupt data with adaptive Huffman encoding")
+{
+    check_corruption(encoding::eof_encoding<256>() | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>());
+    check_corruption(encoding::fused::to_lazy_encoding(encoding::fused::eof<256> | encoding::fused::adaptive_huffman<257> | encoding::fused::bit_grouper<8>, 16));
+}
+
+TEST_CASE("Decompressing corrupt data with static Huffman encoding")
+{
+    REQUIRE(encoding::huffman::register_codebook(101, encoding::huffman::train_codebook(test_data::fibonacci_frequencies(12), 257)));
+
+    check_corruption(encoding::eof_encoding<256>() | encoding::static_huffman_encoding<257>(101) | encoding::bit_grouper<8>());
+}
+
+TEST_CASE("Decompressing corrupt data with move to front and predictive encoding")
+{
+    check_corruption(encoding::move_to_front<256>() | create_pipeline());
+    check_corruption(encoding::move_to_front_fast<256>() | create_pipeline());
+    check_corruption(encoding::predictive_encoding<256>([]() { return encoding::predictive::trie_oracle(2); }) | create_pipeline());
+}
+
+TEST_CASE("Decompressing corrupt data with rANS encoding")
+{
+    check_corruption(encoding::rans_encoding<256>());
+}
+
+TEST_CASE("Decompressing corrupt data with adaptive range encoding")
+{
+    check_corruption(encoding::adaptive_range_encoding<256>());
+}
+
+TEST_CASE("Decompressing corrupt data with LZ77")
+{
+    check_corruption(encoding::lz77<256>() | encoding::adaptive_range_encoding<257>());
+    check_corruption(encoding::lz77<256>(64) | encoding::rans_encoding<257>());
+}
+
+TEST_CASE("Decompressing corrupt data with stored fallback")
+{
+    check_corruption(encoding::stored_fallback(create_pipeline(), 64));
+    check_corruption(encoding::stored_fallback(encoding::lz77<256>() | encoding::rans_encoding<257>(), 64, false));
+}
+
+TEST_CASE("Decompressing a long run of zeros as a Huffman tree fails")
+{
+    std::vector<uint8_t> compressed(100001, 0);
+    std::vector<uint8_t> decompressed(10);
+
+    compressed[0] = 10;
+
+    REQUIRE(encoding::decompress(create_pipeline(), compressed, decompressed) == encoding::COMPRESSION_FAILED);
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/fused/fused.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    template<u64 IN, u64 OUT>
+    std::vector<Datum> encode_dynamically(encoding::Encoding<IN, OUT> encoding, const std::vector<Datum>& data)
+    {
+        io::MemoryBuffer<IN, Datum> original(data);
+        io::MemoryBuffer<OUT, Datum> encoded;
+
+        encoding::encode(original.source(), encoding, encoded.destination());
+
+        return *encoded.data();
+    }
+
+    template<typename PIPELINE>
+    std::vector<Datum> encode_fused(const PIPELINE& pipeline, const std::vector<Datum>& data)
+    {
+        std::vector<Datum> result;
+
+        pipeline.encode(std::span<const Datum>(data), result);
+
+        return result;
+    }
+
+    template<typename PIPELINE>
+    std::vector<Datum> decode_fused(const PIPELINE& pipeline, const std::vector<Datum>& data)
+    {
+        std::vector<Datum> result;
+
+        pipeline.decode(std::span<const Datum>(data), result);
+
+        return result;
+    }
+
+    template<typename PIPELINE, u64 IN, u64 OUT>
+    void check_equivalence(const PIPELINE& pipeline, encoding::Encoding<IN, OUT> dynamic)
+    {
+        auto samples = test_data::create_samples(IN);
+        samples.push_back(std::vector<Datum> { });
+
+        for (auto& sample : samples)
+        {
+            auto encoded = encode_fused(pipeline, sample);
+
+            REQUIRE(encoded == encode_dynamically(dynamic, sample));
+            REQUIRE(encoded.size() <= pipeline.max_encoded_size(sample.size()));
+            REQUIRE(decode_fused(pipeline, encoded) == sample);
+        }
+    }
+}
+
+
+TEST_CASE("Fused EOF encoding produces the same output as the dynamic one")
+{
+    check_equivalence(encoding::fused::eof<16> | encoding::fused::move_to_front<17>, encoding::eof_encoding<16>() | encoding::move_to_front<17>());
+}
+
+TEST_CASE("Fused move to front produces the same output as the dynamic one")
+{
+    check_equivalence(encoding::fused::move_to_front<256> | encoding::fused::move_to_front<256>, encoding::move_to_front_fast<256>() | encoding::move_to_front_fast<256>());
+}
+
+TEST_CASE("Fused adaptive Huffman produces the same output as the dynamic one")
+{
+    check_equivalence(encoding::fused::adaptive_huffman<8> | encoding::fused::bit_grouper<1>, encoding::adaptive_huffman<8>() | encoding::bit_grouper<1>());
+}
+
+TEST_CASE("Fused pipeline produces the same output as the dynamic one")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | adaptive_huffman<257> | bit_grouper<8>;
+
+    check_equivalence(pipeline, encoding::eof_encoding<256>() | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>());
+}
+
+TEST_CASE("Fused pipelines can be concatenated")
+{
+    using namespace encoding::fused;
+
+    auto front = eof<256> | move_to_front<257>;
+    auto back = adaptive_huffman<257> | bit_grouper<3>;
+    auto pipeline = front | back;
+
+    static_assert(std::is_same_v<decltype(pipeline), Pipeline<EofStage<256>, MoveToFrontStage<257>, AdaptiveHuffmanStage<257>, BitGrouperStage<3>>>);
+
+    check_equivalence(pipeline, encoding::eof_encoding<256>() | encoding::move_to_front<257>() | encoding::adaptive_huffman<257>() | encoding::bit_grouper<3>());
+}
+
+TEST_CASE("Fused pipeline as dynamic encoding")
+{
+    using namespace encoding::fused;
+
+    auto encoding = to_encoding(eof<256> | adaptive_huffman<257> | bit_grouper<8>);
+    std::string text = "the quick brown fox jumps over the lazy dog; the quick brown fox jumps over the lazy dog";
+    std::vector<Datum> data(text.begin(), text.end());
+
+    io::MemoryBuffer<256, Datum> original(data);
+    io::MemoryBuffer<256, Datum> encoded;
+    io::MemoryBuffer<256, Datum> decoded;
+
+    encoding::encode(original.source(), encoding, encoded.destination());
+    encoding::decode(encoded.source(), encoding, decoded.destination());
+
+    REQUIRE(*decoded.data() == data);
+    REQUIRE(encoded.data()->size() <= encoding->max_encoded_size(data.size()));
+}
+
+TEST_CASE("Fused pipeline combined with dynamic encodings")
+{
+    using namespace encoding::fused;
+
+    auto encoding = encoding::move_to_front<256>() | to_encoding(eof<256> | adaptive_huffman<257> | bit_grouper<8>);
+    auto data = test_data::pseudo_random(1000, 256, 7);
+
+    io::MemoryBuffer<256, Datum> original(data);
+    io::MemoryBuffer<256, Datum> encoded;
+    io::MemoryBuffer<256, Datum> decoded;
+
+    encoding::encode(original.source(), encoding, encoded.destination());
+    encoding::decode(encoded.source(), encoding, decoded.destination());
+
+    REQUIRE(*decoded.data() == data);
+}
+
+TEST_CASE("Fused pipeline over byte spans")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | adaptive_huffman<257> | bit_grouper<8>;
+    std::string text = "abracadabra";
+    std::vector<uint8_t> data(text.begin(), text.end());
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> decoded;
+
+    pipeline.encode(std::span<const uint8_t>(data), encoded);
+    pipeline.decode(std::span<const uint8_t>(encoded), decoded);
+
+    REQUIRE(decoded == data);
+}
+
+TEST_CASE("Fused pipeline reports truncated input")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | adaptive_huffman<257> | bit_grouper<8>;
+    std::string text = "it was the best of times, it was the worst of times";
+    std::vector<uint8_t> data(text.begin(), text.end());
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> decoded;
+
+    pipeline.encode(std::span<const uint8_t>(data), encoded);
+
+    REQUIRE(pipeline.decode(std::span<const uint8_t>(encoded), decoded));
+
+    encoded.pop_back();
+    decoded.clear();
+
+    REQUIRE(!pipeline.decode(std::span<const uint8_t>(encoded), decoded));
+}
+
+#endif
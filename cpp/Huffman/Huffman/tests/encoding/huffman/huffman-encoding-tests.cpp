@@ -6,6 +6,9 @@
 #include "encoding/huffman/adaptive-huffman-encoding.h"
 #include "encoding/encodings.h"
 #include "io/memory-buffer.h"
+#include "io/files.h"
+#include <cstdio>
+#include <fstream>
 
 
 namespace
@@ -46,6 +49,7 @@ TEST256(1, 1, 2)
 TEST256(1, 1, 2, 2)
 TEST256(1, 2, 3, 2, 1)
 TEST256(1, 1, 2, 3, 3, 4, 4, 4, 4, 3, 2, 1, 2, 3, 4)
+TESTN(70000, 69999, 0, 69999, 65536, 255)
 
 
 namespace
@@ -181,6 +185,106 @@ most other parts of the world at no cost and with almost no restrictions
 whatsoever. You may copy it, give it away or re-use it under the terms
 )")
 
+namespace
+{
+    // Hides the rewindability of the stream it wraps
+    class ForwardOnlyInputStream : public io::InputStream
+    {
+    private:
+        io::InputStream& m_input;
+
+    public:
+        ForwardOnlyInputStream(io::InputStream& input) : m_input(input)
+        {
+            // NOP
+        }
+
+        Datum read() override
+        {
+            return m_input.read();
+        }
+
+        bool end_reached() const override
+        {
+            return m_input.end_reached();
+        }
+    };
+
+    std::vector<uint8_t> sample_text()
+    {
+        std::string text = "It was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness";
+
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+}
+
+TEST_CASE("Huffman Encoding gives same result with and without rewinding")
+{
+    auto huffman = encoding::huffman_encoding<256>();
+    io::MemoryBuffer<256> original(sample_text());
+    io::MemoryBuffer<2> rewound;
+    io::MemoryBuffer<2> buffered;
+
+    auto input = original.source()->create_input_stream();
+    REQUIRE(input->rewindable());
+    huffman->encode(*input, *rewound.destination()->create_output_stream());
+
+    auto rewindable_input = original.source()->create_input_stream();
+    ForwardOnlyInputStream forward_only_input(*rewindable_input);
+    REQUIRE(!forward_only_input.rewindable());
+    huffman->encode(forward_only_input, *buffered.destination()->create_output_stream());
+
+    REQUIRE(*rewound.data() == *buffered.data());
+}
+
+TEST_CASE("Huffman Encoding of a partly read stream only rewinds to where it started")
+{
+    auto huffman = encoding::huffman_encoding<256>();
+    auto text = sample_text();
+    io::MemoryBuffer<256> original(text);
+    io::MemoryBuffer<256> rest(std::vector<uint8_t>(text.begin() + 10, text.end()));
+    io::MemoryBuffer<2> actual;
+    io::MemoryBuffer<2> expected;
+
+    auto input = original.source()->create_input_stream();
+
+    for (int i = 0; i != 10; ++i)
+    {
+        input->read();
+    }
+
+    huffman->encode(*input, *actual.destination()->create_output_stream());
+    encoding::encode(rest.source(), huffman, expected.destination());
+
+    REQUIRE(*actual.data() == *expected.data());
+}
+
+TEST_CASE("Huffman Encoding of file")
+{
+    const char* path = "huffman-encoding-test.tmp";
+    auto text = sample_text();
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(text.data()), text.size());
+    }
+
+    auto huffman = encoding::huffman_encoding<256>();
+    io::MemoryBuffer<2> encoded_file;
+    io::MemoryBuffer<2> encoded_memory;
+    io::MemoryBuffer<256> decoded;
+    io::MemoryBuffer<256> original(text);
+
+    encoding::encode(io::create_file_data_source(path), huffman, encoded_file.destination());
+    encoding::encode(original.source(), huffman, encoded_memory.destination());
+    encoding::decode(encoded_file.source(), huffman, decoded.destination());
+
+    REQUIRE(*encoded_file.data() == *encoded_memory.data());
+    REQUIRE(*decoded.data() == text);
+
+    std::remove(path);
+}
+
 //
 //TEST_CASE("Compression of { }")
 //{
@@ -0,0 +1,114 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+#include <string>
+
+
+namespace
+{
+    std::vector<Datum> to_data(const std::string& string)
+    {
+        return std::vector<Datum>(string.begin(), string.end());
+    }
+
+    // Codebooks live in a process-wide registry, so each test registers its own ID
+    void register_text_codebook(u64 id)
+    {
+        auto corpus = to_data("the quick brown fox jumps over the lazy dog, then the dog sleeps while the fox runs");
+        corpus.push_back(256);
+
+        REQUIRE(encoding::huffman::register_codebook(id, encoding::huffman::train_codebook(corpus, 257)));
+    }
+
+    size_t compressed_size(const std::string& string, encoding::Encoding<257, 2> huffman)
+    {
+        io::MemoryBuffer<256, Datum> original(to_data(string));
+        io::MemoryBuffer<2> compressed;
+
+        encoding::encode(original.source(), encoding::eof_encoding<256>() | huffman, compressed.destination());
+
+        return compressed.data()->size();
+    }
+
+    void check_round_trip(const std::string& string, u64 id)
+    {
+        auto pipeline = encoding::eof_encoding<256>() | encoding::static_huffman_encoding<257>(id);
+        io::MemoryBuffer<256, Datum> original(to_data(string));
+        io::MemoryBuffer<2> compressed;
+        io::MemoryBuffer<256, Datum> decompressed;
+
+        encoding::encode(original.source(), pipeline, compressed.destination());
+        encoding::decode(compressed.source(), pipeline, decompressed.destination());
+
+        REQUIRE(*original.data() == *decompressed.data());
+    }
+}
+
+
+TEST_CASE("Codebook assigns codes to data missing from corpus")
+{
+    auto codebook = encoding::huffman::train_codebook(std::vector<Datum> { 1, 1, 1, 2 }, 4);
+
+    REQUIRE(codebook->code(0).size() > 0);
+    REQUIRE(codebook->code(3).size() > 0);
+    REQUIRE(codebook->code(1).size() < codebook->code(0).size());
+}
+
+TEST_CASE("Codebook registry")
+{
+    auto codebook = encoding::huffman::train_codebook(std::vector<Datum> { 1, 2 }, 4);
+    auto other = encoding::huffman::train_codebook(std::vector<Datum> { 3 }, 4);
+
+    REQUIRE(encoding::huffman::register_codebook(1000, codebook));
+    REQUIRE(!encoding::huffman::register_codebook(1000, other));
+    REQUIRE(encoding::huffman::find_codebook(1000) == codebook);
+    REQUIRE(encoding::huffman::find_codebook(1001) == nullptr);
+}
+
+TEST_CASE("Static Huffman Encoding round trip")
+{
+    register_text_codebook(1);
+
+    check_round_trip("", 1);
+    check_round_trip("the dog", 1);
+    check_round_trip("jumping foxes, lazy dogs", 1);
+    check_round_trip("ZZZ: data that never occurs in the corpus!", 1);
+}
+
+TEST_CASE("Static Huffman Encoding header only stores codebook ID")
+{
+    register_text_codebook(2);
+
+    REQUIRE(compressed_size("", encoding::static_huffman_encoding<257>(2)) == encoding::CODEBOOK_ID_BITS + encoding::huffman::find_codebook(2)->code(256).size());
+}
+
+TEST_CASE("Static Huffman Encoding beats Huffman Encoding on small records")
+{
+    register_text_codebook(3);
+
+    auto record = "the fox sleeps over the dog";
+
+    REQUIRE(compressed_size(record, encoding::static_huffman_encoding<257>(3)) * 2 < compressed_size(record, encoding::huffman_encoding<257>()));
+}
+
+TEST_CASE("Static Huffman Encoding decodes with codebook named in header")
+{
+    register_text_codebook(4);
+    REQUIRE(encoding::huffman::register_codebook(5, encoding::huffman::train_codebook(to_data("aaaaaaaab"), 257)));
+
+    auto encoder = encoding::eof_encoding<256>() | encoding::static_huffman_encoding<257>(4);
+    auto decoder = encoding::eof_encoding<256>() | encoding::static_huffman_encoding<257>(5);
+    io::MemoryBuffer<256, Datum> original(to_data("the lazy fox"));
+    io::MemoryBuffer<2> compressed;
+    io::MemoryBuffer<256, Datum> decompressed;
+
+    encoding::encode(original.source(), encoder, compressed.destination());
+    encoding::decode(compressed.source(), decoder, decompressed.destination());
+
+    REQUIRE(*original.data() == *decompressed.data());
+}
+
+#endif
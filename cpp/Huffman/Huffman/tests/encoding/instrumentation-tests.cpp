@@ -0,0 +1,174 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "encoding/instrumentation.h"
+#include "io/memory-buffer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    using namespace encoding::instrumentation;
+
+    std::vector<Datum> create_data()
+    {
+        std::string text = "she sells sea shells on the sea shore";
+
+        return std::vector<Datum>(text.begin(), text.end());
+    }
+
+    encoding::Encoding<256, 256> create_pipeline(std::shared_ptr<Recorder> recorder)
+    {
+        return encoding::instrumented(encoding::move_to_front<256>(), "mtf", recorder)
+            | encoding::instrumented(encoding::eof_encoding<256>(), "eof", recorder)
+            | encoding::instrumented(encoding::adaptive_huffman<257>(), "huffman", recorder)
+            | encoding::instrumented(encoding::bit_grouper<8>(), "grouper", recorder);
+    }
+
+    std::vector<Datum> round_trip(encoding::Encoding<256, 256> encoding, const std::vector<Datum>& data)
+    {
+        io::MemoryBuffer<256, Datum> original(data);
+        io::MemoryBuffer<256, Datum> encoded;
+        io::MemoryBuffer<256, Datum> decoded;
+
+        encoding::encode(original.source(), encoding, encoded.destination());
+        encoding::decode(encoded.source(), encoding, decoded.destination());
+
+        return *decoded.data();
+    }
+
+    const StageReport& find(const std::vector<StageReport>& reports, const std::string& stage, Operation operation)
+    {
+        for (auto& report : reports)
+        {
+            if (report.stage == stage && report.operation == operation)
+            {
+                return report;
+            }
+        }
+
+        FAIL("No report for " << stage);
+        return reports.front();
+    }
+}
+
+
+TEST_CASE("Instrumented encodings produce unchanged output")
+{
+    auto recorder = std::make_shared<Recorder>();
+    auto data = create_data();
+
+    REQUIRE(round_trip(create_pipeline(recorder), data) == data);
+}
+
+TEST_CASE("Instrumentation counts symbols per stage")
+{
+    auto recorder = std::make_shared<Recorder>();
+    auto data = create_data();
+
+    round_trip(create_pipeline(recorder), data);
+
+    auto reports = recorder->report();
+    REQUIRE(reports.size() == 8);
+
+    auto& mtf = find(reports, "mtf", Operation::ENCODE);
+    auto& eof = find(reports, "eof", Operation::ENCODE);
+    auto& huffman = find(reports, "huffman", Operation::ENCODE);
+    auto& grouper = find(reports, "grouper", Operation::ENCODE);
+
+    REQUIRE(mtf.statistics.calls == 1);
+    REQUIRE(mtf.statistics.symbols_in == data.size());
+    REQUIRE(mtf.statistics.symbols_out == data.size());
+    REQUIRE(eof.statistics.symbols_in == data.size());
+    REQUIRE(eof.statistics.symbols_out == data.size() + 1);
+    REQUIRE(huffman.statistics.symbols_in == data.size() + 1);
+    REQUIRE(grouper.statistics.symbols_in == huffman.statistics.symbols_out);
+    REQUIRE(grouper.statistics.symbols_out == (grouper.statistics.symbols_in + 7) / 8);
+    REQUIRE(huffman.statistics.peak_output == huffman.statistics.symbols_out);
+    REQUIRE(find(reports, "mtf", Operation::DECODE).statistics.symbols_out == data.size());
+}
+
+TEST_CASE("Instrumentation accumulates over calls")
+{
+    auto recorder = std::make_shared<Recorder>();
+    auto encoding = encoding::instrumented(encoding::eof_encoding<256>(), "eof", recorder);
+
+    round_trip(encoding::move_to_front<256>() | encoding | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>(), std::vector<Datum>(10, 1));
+    round_trip(encoding::move_to_front<256>() | encoding | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>(), std::vector<Datum>(20, 1));
+
+    auto reports = recorder->report();
+    auto& report = find(reports, "eof", Operation::ENCODE);
+
+    REQUIRE(report.statistics.calls == 2);
+    REQUIRE(report.statistics.symbols_in == 30);
+    REQUIRE(report.statistics.peak_output == 21);
+    REQUIRE(report.statistics.wall_seconds >= 0);
+    REQUIRE(report.statistics.cpu_seconds >= 0);
+}
+
+TEST_CASE("Disabled instrumentation records nothing")
+{
+    auto recorder = std::make_shared<Recorder>();
+    auto data = create_data();
+
+    recorder->disable();
+
+    REQUIRE(round_trip(create_pipeline(recorder), data) == data);
+    REQUIRE(recorder->report().empty());
+
+    recorder->enable();
+    round_trip(create_pipeline(recorder), data);
+
+    REQUIRE(recorder->report().size() == 8);
+}
+
+TEST_CASE("Instrumentation callback receives every call")
+{
+    std::vector<StageReport> calls;
+    auto recorder = std::make_shared<Recorder>([&](const StageReport& report) { calls.push_back(report); });
+
+    round_trip(create_pipeline(recorder), create_data());
+
+    REQUIRE(calls.size() == 8);
+    REQUIRE(calls[0].stage == "mtf");
+    REQUIRE(calls[0].operation == Operation::ENCODE);
+    REQUIRE(calls[7].stage == "mtf");
+    REQUIRE(calls[7].operation == Operation::DECODE);
+}
+
+TEST_CASE("Instrumentation uses the allocation probe")
+{
+    auto recorder = std::make_shared<Recorder>();
+    static u64 counter = 0;
+
+    set_allocation_probe([]() { counter += 3; return AllocationCounts{ counter, 10 * counter }; });
+    round_trip(create_pipeline(recorder), create_data());
+    set_allocation_probe(nullptr);
+
+    auto reports = recorder->report();
+    auto& report = find(reports, "eof", Operation::ENCODE);
+
+    REQUIRE(report.statistics.allocations == 3);
+    REQUIRE(report.statistics.allocated_bytes == 30);
+}
+
+TEST_CASE("Instrumentation report as JSON")
+{
+    std::vector<StageReport> reports {
+        StageReport{ "a\"b", Operation::ENCODE, StageStatistics{ 1, 2, 3, 0.5, 0.25, 3, 4, 5 } },
+        StageReport{ "c", Operation::DECODE, StageStatistics{ 6, 7, 8, 1, 2, 9, 0, 0 } },
+    };
+
+    REQUIRE(to_json(reports) ==
+        "{\"stages\":["
+        "{\"stage\":\"a\\\"b\",\"operation\":\"encode\",\"calls\":1,\"symbols_in\":2,\"symbols_out\":3,\"wall_seconds\":0.5,\"cpu_seconds\":0.25,\"peak_output\":3,\"allocations\":4,\"allocated_bytes\":5},"
+        "{\"stage\":\"c\",\"operation\":\"decode\",\"calls\":6,\"symbols_in\":7,\"symbols_out\":8,\"wall_seconds\":1,\"cpu_seconds\":2,\"peak_output\":9,\"allocations\":0,\"allocated_bytes\":0}"
+        "]}");
+    REQUIRE(to_json({}) == "{\"stages\":[]}");
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/fused/fused.h"
+#include "encoding/encodings.h"
+#include "io/generator.h"
+#include "io/memory-buffer.h"
+#include <span>
+#include <vector>
+
+
+namespace
+{
+    io::BatchGenerator batches_of(const std::vector<Datum>& data, size_t batch_size, size_t* pulled)
+    {
+        for (size_t i = 0; i < data.size(); i += batch_size)
+        {
+            ++*pulled;
+            co_yield std::span<const Datum>(data).subspan(i, std::min(batch_size, data.size() - i));
+        }
+    }
+
+    std::vector<Datum> collect(io::BatchGenerator batches)
+    {
+        std::vector<Datum> result;
+
+        for (auto batch : batches)
+        {
+            result.insert(result.end(), batch.begin(), batch.end());
+        }
+
+        return result;
+    }
+}
+
+
+TEST_CASE("Lazy pipeline produces the same output as the eager one")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | move_to_front<257> | adaptive_huffman<257> | bit_grouper<8>;
+
+    for (size_t batch_size : { 1, 7, 64, 4096 })
+    {
+        auto data = test_data::pseudo_random(500, 256, batch_size);
+        size_t pulled = 0;
+        std::vector<Datum> eager;
+
+        pipeline.encode(std::span<const Datum>(data), eager);
+        auto lazy = collect(encode_lazily(pipeline, batches_of(data, batch_size, &pulled), batch_size));
+
+        REQUIRE(lazy == eager);
+
+        auto decoded = collect(decode_lazily(pipeline, batches_of(lazy, batch_size, &pulled), batch_size));
+
+        REQUIRE(decoded == data);
+    }
+}
+
+TEST_CASE("Lazy pipeline only pulls the input it needs")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = move_to_front<256> | eof<256>;
+    auto data = test_data::pseudo_random(100000, 256, 1);
+    size_t pulled = 0;
+    auto output = encode_lazily(pipeline, batches_of(data, 100, &pulled), 100);
+
+    REQUIRE(pulled == 0);
+
+    auto it = output.begin();
+
+    REQUIRE((*it).size() == 100);
+    REQUIRE(pulled == 1);
+}
+
+TEST_CASE("Lazy pipeline keeps batches bounded")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | adaptive_huffman<257> | bit_grouper<8>;
+    auto data = test_data::pseudo_random(500, 256, 2);
+    std::vector<Datum> encoded;
+    size_t pulled = 0;
+
+    pipeline.encode(std::span<const Datum>(data), encoded);
+
+    // The EOF decoder produces at most one datum per datum it receives, so it never overshoots the batch size
+    for (auto batch : decode_lazily(pipeline, batches_of(encoded, 16, &pulled), 16))
+    {
+        REQUIRE(batch.size() <= 16);
+    }
+}
+
+TEST_CASE("Lazy pipeline as dynamic encoding")
+{
+    using namespace encoding::fused;
+
+    auto encoding = to_lazy_encoding(eof<256> | adaptive_huffman<257> | bit_grouper<8>, 32);
+    auto data = test_data::pseudo_random(300, 256, 3);
+
+    io::MemoryBuffer<256, Datum> original(data);
+    io::MemoryBuffer<256, Datum> encoded;
+    io::MemoryBuffer<256, Datum> expected;
+    io::MemoryBuffer<256, Datum> decoded;
+
+    encoding::encode(original.source(), encoding, encoded.destination());
+    encoding::encode(original.source(), encoding::eof_encoding<256>() | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>(), expected.destination());
+    encoding::decode(encoded.source(), encoding, decoded.destination());
+
+    REQUIRE(*encoded.data() == *expected.data());
+    REQUIRE(*decoded.data() == data);
+}
+
+TEST_CASE("Lazy pipeline reports truncated input")
+{
+    using namespace encoding::fused;
+
+    auto pipeline = eof<256> | adaptive_huffman<257> | bit_grouper<8>;
+    auto data = test_data::pseudo_random(300, 256, 4);
+    std::vector<Datum> encoded;
+    size_t pulled = 0;
+    bool failed = false;
+
+    pipeline.encode(std::span<const Datum>(data), encoded);
+    encoded.pop_back();
+    collect(decode_lazily(pipeline, batches_of(encoded, 16, &pulled), 16, &failed));
+
+    REQUIRE(failed);
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+#include <string>
+
+
+namespace
+{
+    template<u64 IN, u64 OUT>
+    std::vector<Datum> check(const std::vector<Datum>& data, encoding::Encoding<IN, OUT> encoding)
+    {
+        io::MemoryBuffer<IN, Datum> buffer1(data);
+        io::MemoryBuffer<OUT, Datum> buffer2;
+        io::MemoryBuffer<IN, Datum> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        REQUIRE(data == *buffer3.data());
+
+        return *buffer2.data();
+    }
+
+    std::vector<Datum> from_string(const std::string& string)
+    {
+        std::vector<Datum> result;
+
+        for (auto c : string)
+        {
+            result.push_back(byte(c));
+        }
+
+        return result;
+    }
+
+    std::vector<Datum> json_log(size_t lines)
+    {
+        std::string result;
+
+        for (size_t i = 0; i != lines; ++i)
+        {
+            result += R"({"level":"info","service":"api","request":)" + std::to_string(i * 7919 % 1000) + R"(,"status":200})" "\n";
+        }
+
+        return from_string(result);
+    }
+}
+
+#define TEST(N, ...) TEST_CASE("LZ77 (DS=" #N ") on { " #__VA_ARGS__ " }") { check(std::vector<Datum> { __VA_ARGS__ }, encoding::lz77<N>()); }
+
+TEST(256)
+TEST(256, 1)
+TEST(256, 1, 2)
+TEST(256, 1, 2, 3)
+TEST(256, 1, 2, 3, 1, 2, 3)
+TEST(256, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1)
+TEST(256, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1)
+TEST(256, 255, 255, 255, 255, 255, 0)
+TEST(2, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0)
+TEST(4, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2)
+TEST(70000, 69999, 1, 65536, 69999, 1, 65536, 69999, 1, 65536, 0)
+
+
+TEST_CASE("LZ77 replaces repetitions by matches")
+{
+    auto tokens = check(from_string("abcdefgh abcdefgh abcdefgh"), encoding::lz77<256>());
+
+    REQUIRE(tokens.size() == 9 + 1 + 1 + 2);
+    REQUIRE(tokens[9] == 256);
+}
+
+TEST_CASE("LZ77 on long runs")
+{
+    check(std::vector<Datum>(10000, 42), encoding::lz77<256>());
+}
+
+TEST_CASE("LZ77 with small window")
+{
+    check(json_log(50), encoding::lz77<256>(64));
+}
+
+TEST_CASE("LZ77 followed by Huffman on JSON logs")
+{
+    auto data = json_log(200);
+    auto lz = encoding::lz77<256>() | encoding::eof_encoding<257>() | encoding::huffman_encoding<258>() | encoding::bit_grouper<8>();
+    auto plain = encoding::eof_encoding<256>() | encoding::huffman_encoding<257>() | encoding::bit_grouper<8>();
+
+    auto lz_compressed = check(data, lz);
+    auto plain_compressed = check(data, plain);
+
+    REQUIRE(lz_compressed.size() * 3 < plain_compressed.size());
+}
+
+TEST_CASE("LZ77 decoding rejects impossible matches")
+{
+    auto encoding = encoding::lz77<256>();
+
+    auto decode_fails = [&](const std::vector<Datum>& data) {
+        io::MemoryBuffer<257, Datum> input(data);
+        io::MemoryBuffer<256, Datum> output;
+        auto stream = input.source()->create_input_stream();
+
+        encoding->decode(*stream, *output.destination()->create_output_stream());
+
+        return stream->failed();
+    };
+
+    // The marker is followed by one length digit and two distance digits
+    REQUIRE(!decode_fails(std::vector<Datum> { 1, 2, 256, 0, 1, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 1, 2, 256, 0, 5, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 1, 2, 256, 0, 1 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 1, 2, 256, 0, 256, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 1, 2, 256, 0, 1, 1 }));
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/encodings.h"
+#include "encoding/predictive/oracles.h"
+#include "io/memory-buffer.h"
+
+
+namespace
+{
+    void check_same_as_trie_oracle(unsigned max_depth, const std::vector<Datum>& data)
+    {
+        auto expected = encoding::predictive::trie_oracle(max_depth);
+        auto actual = encoding::predictive::bounded_trie_oracle(max_depth, 1 << 20);
+
+        for (auto& datum : data)
+        {
+            REQUIRE(actual->predict() == expected->predict());
+
+            expected->tell(datum);
+            actual->tell(datum);
+        }
+    }
+
+    void check_round_trip(unsigned max_depth, size_t memory_budget, const std::vector<Datum>& data)
+    {
+        auto encoding = encoding::predictive_encoding<256>([=]() { return encoding::predictive::bounded_trie_oracle(max_depth, memory_budget); });
+        io::MemoryBuffer<256, Datum> buffer1(data);
+        io::MemoryBuffer<256> buffer2;
+        io::MemoryBuffer<256, Datum> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        REQUIRE(data == *buffer3.data());
+    }
+}
+
+
+TEST_CASE("Bounded Trie Oracle predicts like Trie Oracle (depth 1)")
+{
+    check_same_as_trie_oracle(1, test_data::pseudo_random(500, 5, 98765));
+}
+
+TEST_CASE("Bounded Trie Oracle predicts like Trie Oracle (depth 5)")
+{
+    check_same_as_trie_oracle(5, test_data::pseudo_random(2000, 3, 98765));
+}
+
+TEST_CASE("Bounded Trie Oracle starts over when memory runs out")
+{
+    auto oracle = encoding::predictive::bounded_trie_oracle(1, 256);
+
+    for (Datum datum = 0; datum != 200; ++datum)
+    {
+        oracle->tell(datum);
+        oracle->tell(datum);
+    }
+
+    REQUIRE(oracle->predict() == 199);
+}
+
+TEST_CASE("Predictive encoding with Bounded Trie Oracle and tiny budget")
+{
+    check_round_trip(5, 1024, test_data::pseudo_random(5000, 4, 98765));
+}
+
+TEST_CASE("Predictive encoding with Bounded Trie Oracle and large budget")
+{
+    check_round_trip(3, 1 << 20, test_data::pseudo_random(5000, 256, 98765));
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "encoding/predictive/oracles.h"
+#include "io/memory-buffer.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+
+namespace
+{
+    void tell(encoding::predictive::Oracle& oracle, const std::vector<Datum>& data)
+    {
+        for (auto& datum : data)
+        {
+            oracle.tell(datum);
+        }
+    }
+
+    size_t count_hits(encoding::predictive::Oracle& oracle, const std::vector<Datum>& data)
+    {
+        size_t hits = 0;
+
+        for (auto& datum : data)
+        {
+            if (oracle.predict() == datum)
+            {
+                ++hits;
+            }
+
+            oracle.tell(datum);
+        }
+
+        return hits;
+    }
+
+    void check_round_trip(encoding::predictive::OracleFactory oracle_factory, const std::vector<Datum>& data)
+    {
+        auto encoding = encoding::predictive_encoding<256>(oracle_factory);
+        io::MemoryBuffer<256, Datum> buffer1(data);
+        io::MemoryBuffer<256> buffer2;
+        io::MemoryBuffer<256, Datum> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        REQUIRE(data == *buffer3.data());
+    }
+
+    void check_round_trip(unsigned order, unsigned table_bits, const std::vector<Datum>& data)
+    {
+        check_round_trip([=]() { return encoding::predictive::hashed_context_oracle(order, table_bits); }, data);
+    }
+
+    std::vector<Datum> periodic(size_t size, size_t period)
+    {
+        std::vector<Datum> result;
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            result.push_back((i % period) * 37 % 256);
+        }
+
+        return result;
+    }
+}
+
+#define TELL(oracle, ...) tell(oracle, std::vector<Datum> { __VA_ARGS__ } )
+
+
+TEST_CASE("Hashed Context Oracle, initial prediction")
+{
+    auto oracle = encoding::predictive::hashed_context_oracle(2, 10);
+
+    REQUIRE(oracle->predict() == 0);
+}
+
+TEST_CASE("Hashed Context Oracle (order 1), [1,2,1] -> 2")
+{
+    auto oracle = encoding::predictive::hashed_context_oracle(1, 10);
+
+    TELL(*oracle, 1, 2, 1);
+    REQUIRE(oracle->predict() == 2);
+}
+
+TEST_CASE("Hashed Context Oracle (order 2), [1,2,3,4,2,5,1,2] -> 3")
+{
+    auto oracle = encoding::predictive::hashed_context_oracle(2, 10);
+
+    TELL(*oracle, 1, 2, 3, 4, 2, 5, 1, 2);
+    REQUIRE(oracle->predict() == 3);
+}
+
+TEST_CASE("Hashed Context Oracle (order 2), [1,2,3,4,2,5,4,2] -> 5")
+{
+    auto oracle = encoding::predictive::hashed_context_oracle(2, 10);
+
+    TELL(*oracle, 1, 2, 3, 4, 2, 5, 4, 2);
+    REQUIRE(oracle->predict() == 5);
+}
+
+TEST_CASE("Hashed Context Oracle after reset")
+{
+    auto oracle = encoding::predictive::hashed_context_oracle(1, 10);
+
+    TELL(*oracle, 1, 2, 1);
+    oracle->reset();
+    REQUIRE(oracle->predict() == 0);
+}
+
+TEST_CASE("Predictive encoding with Hashed Context Oracle")
+{
+    check_round_trip(3, 12, periodic(5000, 11));
+}
+
+TEST_CASE("Predictive encoding with tiny Hashed Context Oracle")
+{
+    check_round_trip(4, 2, periodic(5000, 97));
+}
+
+TEST_CASE("Pretrained Context Oracle starts out trained")
+{
+    const char* path = "pretrained-context-oracle-test.tmp";
+    REQUIRE(encoding::predictive::train_context_model(std::vector<Datum> { 1, 2, 1 }, 1, 10, path));
+
+    {
+        auto oracle = encoding::predictive::pretrained_context_oracle(encoding::predictive::load_context_model(path));
+
+        TELL(*oracle, 1);
+        REQUIRE(oracle->predict() == 2);
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Pretrained Context Oracle after reset")
+{
+    const char* path = "pretrained-context-oracle-test.tmp";
+    REQUIRE(encoding::predictive::train_context_model(std::vector<Datum> { 1, 2, 1 }, 1, 10, path));
+
+    {
+        auto oracle = encoding::predictive::pretrained_context_oracle(encoding::predictive::load_context_model(path));
+
+        TELL(*oracle, 1, 3, 1, 3, 1);
+        REQUIRE(oracle->predict() == 3);
+        oracle->reset();
+        TELL(*oracle, 1);
+        REQUIRE(oracle->predict() == 2);
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Pretrained Context Oracle predicts short records better")
+{
+    const char* path = "pretrained-context-oracle-test.tmp";
+    REQUIRE(encoding::predictive::train_context_model(periodic(5000, 97), 3, 12, path));
+
+    {
+        auto model = encoding::predictive::load_context_model(path);
+        auto record = periodic(200, 97);
+        auto fresh = encoding::predictive::hashed_context_oracle(3, 12);
+        auto pretrained = encoding::predictive::pretrained_context_oracle(model);
+
+        REQUIRE(count_hits(*pretrained, record) > count_hits(*fresh, record) + 50);
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Predictive encoding with Pretrained Context Oracle")
+{
+    const char* path = "pretrained-context-oracle-test.tmp";
+    REQUIRE(encoding::predictive::train_context_model(periodic(5000, 11), 3, 12, path));
+
+    {
+        auto model = encoding::predictive::load_context_model(path);
+
+        auto factory = [model]() { return encoding::predictive::pretrained_context_oracle(model); };
+
+        check_round_trip(factory, periodic(1000, 13));
+        check_round_trip(factory, periodic(1000, 11));
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Loading a missing or damaged context model gives nullptr")
+{
+    const char* path = "pretrained-context-oracle-test.tmp";
+
+    REQUIRE(encoding::predictive::load_context_model("no-such-context-model.tmp") == nullptr);
+    REQUIRE(encoding::predictive::train_context_model(std::vector<Datum> { 1, 2, 1 }, 1, 10, path));
+
+    std::vector<char> contents;
+
+    {
+        std::ifstream file(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto rewrite = [&](const std::vector<char>& data) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(data.data(), data.size());
+    };
+
+    rewrite(std::vector<char>(contents.begin(), contents.end() - 1));
+    REQUIRE(encoding::predictive::load_context_model(path) == nullptr);
+
+    auto corrupt = contents;
+    corrupt[0] = 'X';
+    rewrite(corrupt);
+    REQUIRE(encoding::predictive::load_context_model(path) == nullptr);
+
+    rewrite(contents);
+    REQUIRE(encoding::predictive::load_context_model(path) != nullptr);
+
+    std::remove(path);
+}
+
+TEST_CASE("Training a context model into an unwritable path fails")
+{
+    REQUIRE(!encoding::predictive::train_context_model(std::vector<Datum> { 1, 2, 1 }, 1, 10, "no-such-directory/context-model.tmp"));
+}
+
+#endif
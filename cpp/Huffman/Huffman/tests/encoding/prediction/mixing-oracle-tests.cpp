@@ -0,0 +1,128 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/encodings.h"
+#include "encoding/predictive/oracles.h"
+#include "io/memory-buffer.h"
+#include <string>
+
+
+namespace
+{
+    void tell(encoding::predictive::Oracle& oracle, const std::vector<Datum>& data)
+    {
+        for (auto& datum : data)
+        {
+            oracle.tell(datum);
+        }
+    }
+
+    size_t count_hits(encoding::predictive::Oracle& oracle, const std::vector<Datum>& data)
+    {
+        size_t hits = 0;
+
+        for (auto& datum : data)
+        {
+            if (oracle.predict() == datum)
+            {
+                ++hits;
+            }
+
+            oracle.tell(datum);
+        }
+
+        return hits;
+    }
+
+    void check_round_trip(unsigned max_order, const std::vector<Datum>& data)
+    {
+        auto encoding = encoding::predictive_encoding<256>([=]() { return encoding::predictive::mixing_oracle(max_order, 12); });
+        io::MemoryBuffer<256, Datum> buffer1(data);
+        io::MemoryBuffer<256> buffer2;
+        io::MemoryBuffer<256, Datum> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        REQUIRE(data == *buffer3.data());
+    }
+
+    std::vector<Datum> text(size_t size)
+    {
+        const std::string words[] = { "the ", "then ", "there ", "these ", "other ", "at ", "that ", "this " };
+        std::vector<Datum> result;
+        test_data::PseudoRandom random(2024);
+
+        while (result.size() < size)
+        {
+            for (auto c : words[random.next() % 8])
+            {
+                result.push_back(byte(c));
+            }
+        }
+
+        result.resize(size);
+
+        return result;
+    }
+}
+
+#define TELL(oracle, ...) tell(oracle, std::vector<Datum> { __VA_ARGS__ } )
+
+
+TEST_CASE("Mixing Oracle, initial prediction")
+{
+    auto oracle = encoding::predictive::mixing_oracle(3, 10);
+
+    REQUIRE(oracle->predict() == 0);
+}
+
+TEST_CASE("Mixing Oracle (order 1), [1,2,1] -> 2")
+{
+    auto oracle = encoding::predictive::mixing_oracle(1, 10);
+
+    TELL(*oracle, 1, 2, 1);
+    REQUIRE(oracle->predict() == 2);
+}
+
+TEST_CASE("Mixing Oracle falls back on shorter contexts")
+{
+    auto oracle = encoding::predictive::mixing_oracle(3, 10);
+
+    TELL(*oracle, 1, 2, 5, 6, 2);
+    REQUIRE(oracle->predict() == 5);
+}
+
+TEST_CASE("Mixing Oracle after reset")
+{
+    auto oracle = encoding::predictive::mixing_oracle(3, 10);
+
+    TELL(*oracle, 1, 2, 1);
+    oracle->reset();
+    REQUIRE(oracle->predict() == 0);
+}
+
+TEST_CASE("Mixing Oracle predicts at least as well as its individual orders")
+{
+    auto data = text(20000);
+    auto mixing = encoding::predictive::mixing_oracle(4, 16);
+    auto order1 = encoding::predictive::hashed_context_oracle(1, 16);
+    auto order4 = encoding::predictive::hashed_context_oracle(4, 16);
+
+    auto mixing_hits = count_hits(*mixing, data);
+    auto order1_hits = count_hits(*order1, data);
+    auto order4_hits = count_hits(*order4, data);
+
+    REQUIRE(mixing_hits >= order1_hits);
+    REQUIRE(mixing_hits >= order4_hits);
+}
+
+TEST_CASE("Predictive encoding with Mixing Oracle")
+{
+    check_round_trip(1, text(3000));
+    check_round_trip(5, text(3000));
+}
+
+#endif
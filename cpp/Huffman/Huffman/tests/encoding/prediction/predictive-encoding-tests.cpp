@@ -7,13 +7,14 @@
 #include "io/memory-buffer.h"
 #include "io/io-util.h"
 #include <functional>
+#include <thread>
 
 
 namespace
 {
-    void check(std::unique_ptr<encoding::predictive::Oracle> oracle, const std::vector<Datum>& data)
+    void check(encoding::predictive::OracleFactory oracle_factory, const std::vector<Datum>& data)
     {
-        auto encoding = encoding::predictive_encoding<256>(std::move(oracle));
+        auto encoding = encoding::predictive_encoding<256>(oracle_factory);
         io::MemoryBuffer<256, Datum> buffer1(data);
         io::MemoryBuffer<256> buffer2;
         io::MemoryBuffer<256> buffer3;
@@ -31,14 +32,14 @@ namespace
         }
     }
 
-    std::unique_ptr<encoding::predictive::Oracle> constant(Datum datum)
+    encoding::predictive::OracleFactory constant(Datum datum)
     {
-        return encoding::predictive::constant_oracle(datum);
+        return [datum]() { return encoding::predictive::constant_oracle(datum); };
     }
 
-    std::unique_ptr<encoding::predictive::Oracle> repeat(Datum datum)
+    encoding::predictive::OracleFactory repeat(Datum datum)
     {
-        return encoding::predictive::repeating_oracle(datum);
+        return [datum]() { return encoding::predictive::repeating_oracle(datum); };
     }
 }
 
@@ -60,4 +61,47 @@ TEST(1, 1, 1, 1, 1)
 TEST(1, 2, 3, 4, 1, 2, 3, 4)
 TEST(1, 2, 3, 4, 5, 4, 3, 2, 1)
 
+
+TEST_CASE("Predictive Encoding shared between threads")
+{
+    auto pipeline = encoding::predictive_encoding<256>([]() { return encoding::predictive::trie_oracle(3); }) | encoding::eof_encoding<256>() | encoding::adaptive_huffman<257>() | encoding::bit_grouper<8>();
+    std::vector<std::thread> threads;
+    std::vector<int> successes(4, 0);
+
+    for (unsigned t = 0; t != successes.size(); ++t)
+    {
+        threads.emplace_back([&pipeline, &successes, t]() {
+            for (unsigned round = 0; round != 20; ++round)
+            {
+                std::vector<Datum> data;
+
+                for (unsigned i = 0; i != 500; ++i)
+                {
+                    data.push_back((i * (t + 1) + round) % 7 * 31);
+                }
+
+                io::MemoryBuffer<256, Datum> buffer1(data);
+                io::MemoryBuffer<256> buffer2;
+                io::MemoryBuffer<256, Datum> buffer3;
+
+                encoding::encode(buffer1.source(), pipeline, buffer2.destination());
+                encoding::decode(buffer2.source(), pipeline, buffer3.destination());
+
+                successes[t] += data == *buffer3.data();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Catch's assertions are not thread safe, so results are only checked once all threads are done
+    for (auto count : successes)
+    {
+        REQUIRE(count == 20);
+    }
+}
+
 #endif
@@ -2,6 +2,8 @@
 
 #include "encoding/predictive/trie-oracle.h"
 #include "catch.hpp"
+#include "tests/test-data.h"
+#include <map>
 
 
 
@@ -16,6 +18,49 @@ namespace
     }
 }
 
+namespace
+{
+    // Straightforward but slow reference: the prediction is the datum that most often
+    // followed the longest context (of at most max_depth data) that has been seen before
+    Datum reference_prediction(const std::vector<Datum>& history, unsigned max_depth)
+    {
+        for (size_t length = std::min<size_t>(max_depth, history.size()); length > 0; --length)
+        {
+            std::map<Datum, u64> counts;
+
+            for (size_t end = length; end < history.size(); ++end)
+            {
+                if (std::equal(history.end() - length, history.end(), history.begin() + (end - length)))
+                {
+                    counts[history[end]]++;
+                }
+            }
+
+            if (!counts.empty())
+            {
+                return std::max_element(counts.begin(), counts.end(), [](const std::pair<const Datum, u64>& p, const std::pair<const Datum, u64>& q) { return p.second < q.second; })->first;
+            }
+        }
+
+        return 0;
+    }
+
+    void check_against_reference(unsigned max_depth, const std::vector<Datum>& data)
+    {
+        auto oracle = encoding::predictive::trie_oracle(max_depth);
+        std::vector<Datum> history;
+
+        for (auto& datum : data)
+        {
+            REQUIRE(oracle->predict() == reference_prediction(history, max_depth));
+
+            oracle->tell(datum);
+            history.push_back(datum);
+        }
+    }
+
+}
+
 #define TELL(oracle, ...) tell(oracle, std::vector<Datum> { __VA_ARGS__ } )
 
 
@@ -98,4 +143,38 @@ TEST_CASE("Trie Oracle (depth 2), [1,2,1,1,2,1,1,2,1,3,2,3,3,2,3,3,2,3,3,2,3,3,2
     REQUIRE(oracle->predict() == 3);
 }
 
+TEST_CASE("Trie Oracle (depth 0) never predicts")
+{
+    auto oracle = encoding::predictive::trie_oracle(0);
+
+    TELL(*oracle, 1, 1, 1, 1);
+    REQUIRE(oracle->predict() == 0);
+}
+
+TEST_CASE("Trie Oracle matches reference (depth 1)")
+{
+    check_against_reference(1, test_data::pseudo_random(200, 4, 12345));
+}
+
+TEST_CASE("Trie Oracle matches reference (depth 3)")
+{
+    check_against_reference(3, test_data::pseudo_random(300, 3, 12345));
+}
+
+TEST_CASE("Trie Oracle matches reference (depth 5)")
+{
+    check_against_reference(5, test_data::pseudo_random(300, 2, 12345));
+}
+
+TEST_CASE("Trie Oracle after reset")
+{
+    auto oracle = encoding::predictive::trie_oracle(2);
+
+    TELL(*oracle, 1, 2, 1, 2, 1);
+    oracle->reset();
+    REQUIRE(oracle->predict() == 0);
+    TELL(*oracle, 3, 3);
+    REQUIRE(oracle->predict() == 3);
+}
+
 #endif
@@ -0,0 +1,125 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+
+
+namespace
+{
+    template<u64 IN>
+    void check(const std::vector<Datum>& data)
+    {
+        auto encoding = encoding::rans_encoding<IN>();
+        io::MemoryBuffer<IN, Datum> buffer1(data);
+        io::MemoryBuffer<256> buffer2;
+        io::MemoryBuffer<IN> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        auto results = buffer3.data();
+
+        REQUIRE(data.size() == results->size());
+
+        for (size_t i = 0; i != data.size(); ++i)
+        {
+            REQUIRE(data[i] == (*results)[i]);
+        }
+    }
+
+    std::vector<Datum> skewed(size_t size)
+    {
+        std::vector<Datum> result;
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            result.push_back(i % 17 == 0 ? i % 5 + 1 : 0);
+        }
+
+        return result;
+    }
+}
+
+#define TESTN(N, ...) TEST_CASE("rANS Encoding (DS=" #N ") on { " #__VA_ARGS__ " }") { check<N>(std::vector<Datum> { __VA_ARGS__ }); }
+
+#define TEST4(...)   TESTN(4, __VA_ARGS__)
+#define TEST256(...) TESTN(256, __VA_ARGS__)
+#define TEST257(...) TESTN(257, __VA_ARGS__)
+
+TEST4()
+TEST4(0)
+TEST4(3)
+TEST4(0, 1)
+TEST4(3, 3, 3, 3)
+TEST256(0, 1)
+TEST256(1, 2)
+TEST256(1, 1, 2)
+TEST256(255, 0, 255, 0)
+TEST256(1, 2, 3, 2, 1)
+TEST256(1, 1, 2, 3, 3, 4, 4, 4, 4, 3, 2, 1, 2, 3, 4)
+TEST257(256)
+TEST257(0, 256, 255, 1)
+TESTN(70000, 69999, 0, 69999, 65536, 255)
+
+
+TEST_CASE("rANS Encoding on skewed data")
+{
+    check<256>(skewed(10000));
+}
+
+TEST_CASE("rANS Encoding on all byte values")
+{
+    std::vector<Datum> data;
+
+    for (Datum i = 0; i != 256 * 3; ++i)
+    {
+        data.push_back((i * 7) % 256);
+    }
+
+    check<256>(data);
+}
+
+TEST_CASE("rANS Encoding compresses skewed data below one bit per symbol")
+{
+    auto data = skewed(10000);
+    io::MemoryBuffer<256, Datum> original(data);
+    io::MemoryBuffer<256> compressed;
+
+    encoding::encode(original.source(), encoding::rans_encoding<256>(), compressed.destination());
+
+    REQUIRE(compressed.data()->size() * 8 < data.size());
+}
+
+TEST_CASE("rANS decoding rejects corrupt frequencies and truncated data")
+{
+    auto encoding = encoding::rans_encoding<256>();
+    io::MemoryBuffer<256, Datum> original(skewed(1000));
+    io::MemoryBuffer<256> compressed;
+
+    encoding::encode(original.source(), encoding, compressed.destination());
+
+    auto decode_fails = [&](const std::vector<uint8_t>& data) {
+        io::MemoryBuffer<256> input(data);
+        io::MemoryBuffer<256> output;
+        auto stream = input.source()->create_input_stream();
+
+        encoding->decode(*stream, *output.destination()->create_output_stream());
+
+        return stream->failed();
+    };
+
+    auto data = *compressed.data();
+
+    REQUIRE(!decode_fails(data));
+
+    // Size, count, then the first value and the low byte of its frequency
+    auto corrupt = data;
+    ++corrupt[8 + 2 + 1 + 1];
+
+    REQUIRE(decode_fails(corrupt));
+    REQUIRE(decode_fails(std::vector<uint8_t>(data.begin(), data.end() - 1)));
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "tests/test-data.h"
+#include "encoding/encodings.h"
+#include "io/memory-buffer.h"
+#include <vector>
+
+
+namespace
+{
+    template<u64 IN, u64 OUT>
+    std::vector<Datum> check(const std::vector<Datum>& data, encoding::Encoding<IN, OUT> encoding)
+    {
+        io::MemoryBuffer<IN, Datum> buffer1(data);
+        io::MemoryBuffer<OUT, Datum> buffer2;
+        io::MemoryBuffer<IN, Datum> buffer3;
+
+        encoding::encode(buffer1.source(), encoding, buffer2.destination());
+        encoding::decode(buffer2.source(), encoding, buffer3.destination());
+
+        REQUIRE(data == *buffer3.data());
+        REQUIRE(buffer2.data()->size() <= encoding->max_encoded_size(data.size()));
+
+        return *buffer2.data();
+    }
+
+    encoding::Encoding<256, 2> eof_huffman()
+    {
+        return encoding::eof_encoding<256>() | encoding::huffman_encoding<257>();
+    }
+
+    std::vector<Datum> concatenate(std::vector<Datum> xs, const std::vector<Datum>& ys)
+    {
+        xs.insert(xs.end(), ys.begin(), ys.end());
+
+        return xs;
+    }
+}
+
+#define TEST(...) TEST_CASE("Stored fallback around EOF and Huffman on { " #__VA_ARGS__ " }") { check(std::vector<Datum> { __VA_ARGS__ }, encoding::stored_fallback(eof_huffman(), 4)); }
+
+TEST()
+TEST(1)
+TEST(1, 2)
+TEST(1, 1, 1, 1)
+TEST(1, 1, 1, 1, 1)
+TEST(0, 255, 0, 255, 0, 255, 0, 255, 0)
+TEST(7, 7, 7, 7, 1, 2, 3, 4, 7, 7, 7)
+
+
+TEST_CASE("Stored fallback stores random data")
+{
+    auto data = test_data::random_bytes(1000, 1);
+    auto encoded = check(data, encoding::stored_fallback(eof_huffman(), 1000));
+
+    // Flag, 13 bits for the block size, 8 bits per datum, and the same header for the empty block marking the end
+    REQUIRE(encoded.size() == 1 + 13 + 8 * data.size() + 1 + 13);
+    REQUIRE(encoded[0] == 0);
+}
+
+TEST_CASE("Stored fallback encodes compressible data")
+{
+    std::vector<Datum> data(1000, 42);
+    data[500] = 43;
+
+    auto encoded = check(data, encoding::stored_fallback(eof_huffman(), 1000));
+
+    REQUIRE(encoded.size() < 8 * data.size() / 4);
+    REQUIRE(encoded[0] == 1);
+}
+
+TEST_CASE("Stored fallback decides per block")
+{
+    auto data = concatenate(concatenate(test_data::random_bytes(1000, 2), std::vector<Datum>(1000, 3)), test_data::random_bytes(500, 4));
+    auto encoding = encoding::stored_fallback(eof_huffman(), 1000);
+    auto encoded = check(data, encoding);
+
+    REQUIRE(encoded[0] == 0);
+    REQUIRE(encoded[1 + 13 + 8 * 1000] == 1);
+    REQUIRE(encoded.size() < 8 * data.size());
+}
+
+TEST_CASE("Stored fallback with output domain equal to input domain copies stored data")
+{
+    auto data = test_data::random_bytes(300, 5);
+    auto encoded = check(data, encoding::stored_fallback(encoding::move_to_front<256>(), 100));
+
+    REQUIRE(encoded.size() == 3 * (1 + 1 + 100) + 1 + 1);
+    REQUIRE(std::vector<Datum>(encoded.begin() + 2, encoded.begin() + 102) == std::vector<Datum>(data.begin(), data.begin() + 100));
+}
+
+TEST_CASE("Stored fallback without entropy estimation tries context based encodings")
+{
+    // Every byte occurs equally often, so the order 0 entropy is the maximum
+    std::vector<Datum> data;
+
+    for (unsigned i = 0; i != 16; ++i)
+    {
+        for (Datum datum = 0; datum != 256; ++datum)
+        {
+            data.push_back(datum * 167 % 256);
+        }
+    }
+
+    auto estimated = check(data, encoding::stored_fallback(encoding::lz77<256>(), 4096, true));
+    auto tried = check(data, encoding::stored_fallback(encoding::lz77<256>(), 4096, false));
+
+    REQUIRE(estimated[0] == 0);
+    REQUIRE(tried[0] == 1);
+    REQUIRE(tried.size() < estimated.size() / 4);
+}
+
+TEST_CASE("Stored fallback ignores padding after the end")
+{
+    auto data = concatenate(test_data::random_bytes(1001, 7), std::vector<Datum>(500, 8));
+
+    check(data, encoding::stored_fallback(eof_huffman(), 1000) | encoding::bit_grouper<8>());
+}
+
+TEST_CASE("Stored fallback on small domains")
+{
+    std::vector<Datum> data{ 0, 1, 2, 3, 0, 1, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 };
+
+    auto encoding = encoding::eof_encoding<4>() | encoding::huffman_encoding<5>();
+
+    check(data, encoding::stored_fallback(encoding, 5));
+    check(data, encoding::stored_fallback(encoding, 5, false));
+}
+
+TEST_CASE("Stored fallback rejects unknown flags and truncated data")
+{
+    auto encoding = encoding::stored_fallback(encoding::lz77<255>(), 16, false);
+
+    auto decode_fails = [&](const std::vector<Datum>& data) {
+        io::MemoryBuffer<256, Datum> input(data);
+        io::MemoryBuffer<255, Datum> output;
+        auto stream = input.source()->create_input_stream();
+
+        encoding->decode(*stream, *output.destination()->create_output_stream());
+
+        return stream->failed();
+    };
+
+    // Flag, size and the data of a stored block, then the empty block that ends it all
+    REQUIRE(!decode_fails(std::vector<Datum> { 0, 1, 5, 0, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 2, 1, 5, 0, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 0, 1, 255, 0, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 0, 2, 5, 0, 0 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 0, 1, 5 }));
+    REQUIRE(decode_fails(std::vector<Datum> { 0, 1 }));
+}
+
+#endif
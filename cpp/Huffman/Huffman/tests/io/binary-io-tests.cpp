@@ -36,4 +36,39 @@ TEST(256, 16)
 TEST(4876, 16)
 TEST(23468, 16)
 
+
+namespace
+{
+    void check_bytes(u64 n, unsigned nbytes)
+    {
+        io::MemoryBuffer<256> buffer;
+        auto input = buffer.source()->create_input_stream();
+        auto output = buffer.destination()->create_output_stream();
+        io::write_bytes(n, nbytes, *output);
+        auto result = io::read_bytes(nbytes, *input);
+
+        REQUIRE(buffer.data()->size() == nbytes);
+        REQUIRE(n == result);
+    }
+}
+
+#define TEST_BYTES(n, nbytes) TEST_CASE("Converting " #n " to bytes and back (" #nbytes " bytes)") { check_bytes(n, nbytes); }
+
+
+TEST_BYTES(0, 1)
+TEST_BYTES(255, 1)
+TEST_BYTES(256, 2)
+TEST_BYTES(23468, 2)
+TEST_BYTES(0x12345678, 4)
+TEST_BYTES(0xFFFFFFFFFFFFFFFF, 8)
+
+TEST_CASE("Reading past the end reads zeros and fails the stream")
+{
+    io::MemoryBuffer<256> buffer(std::vector<uint8_t> { 0x12 });
+    auto input = buffer.source()->create_input_stream();
+
+    REQUIRE(io::read_bytes(2, *input) == 0x1200);
+    REQUIRE(input->failed());
+}
+
 #endif
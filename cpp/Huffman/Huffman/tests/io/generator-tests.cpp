@@ -0,0 +1,93 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "io/generator.h"
+#include "io/memory-buffer.h"
+#include <vector>
+
+
+namespace
+{
+    io::Generator<int> count_to(int n, int* resumptions)
+    {
+        for (int i = 0; i != n; ++i)
+        {
+            ++*resumptions;
+            co_yield i;
+        }
+    }
+}
+
+
+TEST_CASE("Generator yields all values")
+{
+    int resumptions = 0;
+    std::vector<int> values;
+
+    for (auto value : count_to(5, &resumptions))
+    {
+        values.push_back(value);
+    }
+
+    REQUIRE(values == std::vector<int> { 0, 1, 2, 3, 4 });
+}
+
+TEST_CASE("Generator runs on demand")
+{
+    int resumptions = 0;
+    auto generator = count_to(1000, &resumptions);
+
+    REQUIRE(resumptions == 0);
+
+    for (auto value : generator)
+    {
+        if (value == 2)
+        {
+            break;
+        }
+    }
+
+    REQUIRE(resumptions == 3);
+}
+
+TEST_CASE("Empty generator")
+{
+    int resumptions = 0;
+    auto generator = count_to(0, &resumptions);
+
+    REQUIRE(generator.begin() == generator.end());
+}
+
+TEST_CASE("Reading batches from a stream")
+{
+    std::vector<Datum> data { 1, 2, 3, 4, 5, 6, 7 };
+    io::MemoryBuffer<8, Datum> buffer(data);
+    auto input = buffer.source()->create_input_stream();
+    std::vector<size_t> sizes;
+    std::vector<Datum> contents;
+
+    for (auto batch : io::read_batches(*input, 3))
+    {
+        sizes.push_back(batch.size());
+        contents.insert(contents.end(), batch.begin(), batch.end());
+    }
+
+    REQUIRE(sizes == std::vector<size_t> { 3, 3, 1 });
+    REQUIRE(contents == data);
+}
+
+TEST_CASE("Writing batches to a stream")
+{
+    std::vector<Datum> data { 1, 2, 3, 4, 5, 6, 7 };
+    io::MemoryBuffer<8, Datum> original(data);
+    io::MemoryBuffer<8, Datum> copy;
+    auto input = original.source()->create_input_stream();
+    auto output = copy.destination()->create_output_stream();
+
+    io::write_batches(io::read_batches(*input, 2), *output);
+
+    REQUIRE(*copy.data() == data);
+}
+
+#endif
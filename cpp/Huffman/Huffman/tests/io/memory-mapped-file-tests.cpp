@@ -0,0 +1,57 @@
+#ifdef TEST_BUILD
+
+#include "io/memory-mapped-file.h"
+#include "util.h"
+#include "catch.hpp"
+#include <cstdio>
+#include <fstream>
+
+
+TEST_CASE("Memory mapped file contains file contents")
+{
+    const char* path = "memory-mapped-file-test.tmp";
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "abc";
+    }
+
+    {
+        io::MemoryMappedFile mapped(path);
+
+        REQUIRE(mapped.is_open());
+        REQUIRE(mapped.size() == 3);
+        REQUIRE(mapped.data()[0] == 'a');
+        REQUIRE(mapped.data()[1] == 'b');
+        REQUIRE(mapped.data()[2] == 'c');
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Memory mapped file of empty file is open, but has no data")
+{
+    const char* path = "empty-memory-mapped-file-test.tmp";
+
+    {
+        std::ofstream file(path, std::ios::binary);
+    }
+
+    {
+        io::MemoryMappedFile mapped(path);
+
+        REQUIRE(mapped.is_open());
+        REQUIRE(mapped.size() == 0);
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("Memory mapped file of missing file")
+{
+    io::MemoryMappedFile mapped("missing-memory-mapped-file-test.tmp");
+
+    REQUIRE(!mapped.is_open());
+}
+
+#endif
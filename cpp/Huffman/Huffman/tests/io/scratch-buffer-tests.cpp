@@ -0,0 +1,70 @@
+#ifdef TEST_BUILD
+
+#include "catch.hpp"
+#include "util.h"
+#include "io/scratch-buffer.h"
+#include <vector>
+
+
+namespace
+{
+    // Element type of its own, so that no other test shares the pool
+    struct Element
+    {
+        u64 value;
+    };
+
+    typedef io::ScratchBuffer<Element> Buffer;
+}
+
+TEST_CASE("Scratch buffers are returned empty, with their capacity")
+{
+    {
+        Buffer buffer;
+        buffer->resize(100);
+    }
+
+    Buffer buffer;
+
+    REQUIRE(buffer->empty());
+    REQUIRE(buffer->capacity() >= 100);
+}
+
+TEST_CASE("Large scratch buffers are released rather than kept")
+{
+    {
+        Buffer buffer;
+        buffer->resize(Buffer::MAX_RETAINED_BYTES / sizeof(Element) + 1);
+    }
+
+    Buffer buffer;
+
+    REQUIRE(buffer->capacity() * sizeof(Element) <= Buffer::MAX_RETAINED_BYTES);
+}
+
+TEST_CASE("Scratch buffer pool is bounded")
+{
+    {
+        std::vector<Buffer> buffers(2 * Buffer::MAX_POOL_SIZE);
+
+        for (auto& buffer : buffers)
+        {
+            buffer->resize(1);
+        }
+    }
+
+    std::vector<Buffer> buffers(2 * Buffer::MAX_POOL_SIZE);
+    size_t reused = 0;
+
+    for (auto& buffer : buffers)
+    {
+        if (buffer->capacity() > 0)
+        {
+            ++reused;
+        }
+    }
+
+    REQUIRE(reused == Buffer::MAX_POOL_SIZE);
+}
+
+#endif
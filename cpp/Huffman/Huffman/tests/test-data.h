@@ -0,0 +1,91 @@
+#ifndef TEST_DATA_H
+#define TEST_DATA_H
+
+#include "util.h"
+#include <vector>
+
+
+namespace test_data
+{
+    // Linear congruential generator (Knuth's MMIX constants), so that tests see the same data on every run
+    class PseudoRandom
+    {
+    private:
+        u64 m_state;
+
+    public:
+        PseudoRandom(u64 seed) : m_state(seed)
+        {
+            // NOP
+        }
+
+        // The top 31 bits of the state; the lower bits of an LCG are far from random
+        u64 next()
+        {
+            m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+
+            return m_state >> 33;
+        }
+    };
+
+    inline std::vector<Datum> pseudo_random(size_t size, u64 domain_size, u64 seed)
+    {
+        PseudoRandom random(seed);
+        std::vector<Datum> result;
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            result.push_back(random.next() % domain_size);
+        }
+
+        return result;
+    }
+
+    // Uniformly distributed bytes, taken from the top bits only
+    inline std::vector<Datum> random_bytes(size_t size, u64 seed)
+    {
+        PseudoRandom random(seed);
+        std::vector<Datum> result;
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            result.push_back(random.next() >> 23);
+        }
+
+        return result;
+    }
+
+    // Frequencies 1, 1, 2, 3, 5, 8, ... produce the deepest possible Huffman tree
+    inline std::vector<Datum> fibonacci_frequencies(unsigned count)
+    {
+        std::vector<Datum> result;
+        u64 a = 1, b = 1;
+
+        for (unsigned datum = 0; datum != count; ++datum)
+        {
+            result.insert(result.end(), a, datum);
+
+            auto sum = a + b;
+            a = b;
+            b = sum;
+        }
+
+        return result;
+    }
+
+    // Nonempty inputs of all sizes and distributions that encodings over domain_size should handle
+    inline std::vector<std::vector<Datum>> create_samples(u64 domain_size)
+    {
+        return std::vector<std::vector<Datum>> {
+            std::vector<Datum> { 0, 1 },
+            pseudo_random(1, domain_size, 1),
+            pseudo_random(100, domain_size, 2),
+            pseudo_random(5000, domain_size, 3),
+            pseudo_random(5000, 2, 4),
+            fibonacci_frequencies(domain_size < 12 ? unsigned(domain_size) : 12),
+            std::vector<Datum>(1000, 0),
+        };
+    }
+}
+
+#endif
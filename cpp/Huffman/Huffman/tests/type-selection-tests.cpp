@@ -31,4 +31,23 @@ void test_types()
 #undef CHECK_TYPE
 }
 
+namespace
+{
+    size_t selected_size(u64 domain_size)
+    {
+        return with_integer_type_for_domain_size(domain_size, [](auto type) { return sizeof(type); });
+    }
+}
+
+TEST_CASE("Integer type selection at runtime")
+{
+    REQUIRE(selected_size(2) == 1);
+    REQUIRE(selected_size(256) == 1);
+    REQUIRE(selected_size(257) == 2);
+    REQUIRE(selected_size(65536) == 2);
+    REQUIRE(selected_size(65537) == 4);
+    REQUIRE(selected_size(4294967296) == 4);
+    REQUIRE(selected_size(4294967297) == 8);
+}
+
 #endif
@@ -111,4 +111,24 @@ template<u64 DOMAIN_SIZE> struct SelectIntegerTypeByDomainSize
     typedef typename SelectIntegerTypeByBytes<bytes_needed(DOMAIN_SIZE)>::type type;
 };
 
+// Runtime counterpart of SelectIntegerTypeByDomainSize: calls f with a value of the selected type,
+// so that f can set up buffers with the right element type using decltype
+template<typename F>
+auto with_integer_type_for_domain_size(u64 domain_size, F f)
+{
+    switch (bytes_needed(domain_size))
+    {
+    case 0:
+    case 1:
+        return f(uint8_t());
+    case 2:
+        return f(uint16_t());
+    case 3:
+    case 4:
+        return f(uint32_t());
+    default:
+        return f(uint64_t());
+    }
+}
+
 #endif